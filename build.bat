@@ -1,5 +1,7 @@
 @echo off
 
+git submodule update --init
+
 IF NOT EXIST build\ (
     mkdir build
 )
@@ -1,3 +1,5 @@
+git submodule update --init
+
 mkdir build
 cd build
 cmake -DCMAKE_BUILD_TYPE=Release ..
@@ -4,6 +4,7 @@
 #include "angelscript/addon/scriptdictionary/scriptdictionary.h"
 #include "angelscript/addon/scriptany/scriptany.h"
 #include "../helpers/convert.h"
+#include "../helpers/typedargs.h"
 
 using namespace Helpers;
 
@@ -22,28 +23,75 @@ static void LogError(const std::string& msg)
     Log::Error << msg << Log::Endl;
 }
 
-static uint32_t SetTimeout(asIScriptFunction* callback, uint32_t timeout)
+static uint32_t SetTimeout(asIScriptFunction* callback, uint32_t timeout, Helpers::TimerToken* token)
 {
     GET_RESOURCE();
-    return resource->CreateTimer(timeout, callback, true);
+    Helpers::Timer timer{callback, timeout, resource->GetTime(), true};
+    timer.SetToken(token);
+    return resource->AddTimer(timer);
 }
 
-static uint32_t SetInterval(asIScriptFunction* callback, uint32_t interval)
+static uint32_t SetTimeoutWithValue(asIScriptFunction* callback, uint32_t timeout, int64_t value, Helpers::TimerToken* token)
 {
     GET_RESOURCE();
-    return resource->CreateTimer(interval, callback, false);
+    Helpers::Timer timer{callback, timeout, resource->GetTime(), true};
+    timer.SetArg(value);
+    timer.SetToken(token);
+    return resource->AddTimer(timer);
+}
+
+static uint32_t SetTimeoutWithPlayer(asIScriptFunction* callback, uint32_t timeout, alt::IPlayer* player, Helpers::TimerToken* token)
+{
+    GET_RESOURCE();
+    auto runtime = resource->GetRuntime();
+    Helpers::Timer timer{callback, timeout, resource->GetTime(), true};
+    timer.SetArgHandle(player, runtime->GetEngine()->GetTypeInfoById(runtime->GetPlayerTypeId()));
+    timer.SetToken(token);
+    return resource->AddTimer(timer);
+}
+
+static uint32_t SetInterval(asIScriptFunction* callback, uint32_t interval, Helpers::TimerToken* token)
+{
+    GET_RESOURCE();
+    Helpers::Timer timer{callback, interval, resource->GetTime(), false};
+    timer.SetToken(token);
+    return resource->AddTimer(timer);
+}
+
+static uint32_t SetIntervalWithValue(asIScriptFunction* callback, uint32_t interval, int64_t value, Helpers::TimerToken* token)
+{
+    GET_RESOURCE();
+    Helpers::Timer timer{callback, interval, resource->GetTime(), false};
+    timer.SetArg(value);
+    timer.SetToken(token);
+    return resource->AddTimer(timer);
+}
+
+static uint32_t SetIntervalWithPlayer(asIScriptFunction* callback, uint32_t interval, alt::IPlayer* player, Helpers::TimerToken* token)
+{
+    GET_RESOURCE();
+    auto runtime = resource->GetRuntime();
+    Helpers::Timer timer{callback, interval, resource->GetTime(), false};
+    timer.SetArgHandle(player, runtime->GetEngine()->GetTypeInfoById(runtime->GetPlayerTypeId()));
+    timer.SetToken(token);
+    return resource->AddTimer(timer);
+}
+
+static Helpers::TimerToken* TimerTokenFactory()
+{
+    return new Helpers::TimerToken();
 }
 
 static uint32_t NextTick(asIScriptFunction* callback)
 {
     GET_RESOURCE();
-    return resource->CreateTimer(0, callback, true);
+    return resource->AddTickCallback(callback, true);
 }
 
 static uint32_t EveryTick(asIScriptFunction* callback)
 {
     GET_RESOURCE();
-    return resource->CreateTimer(0, callback, false);
+    return resource->AddTickCallback(callback, false);
 }
 
 static void ClearTimer(uint32_t id)
@@ -52,6 +100,45 @@ static void ClearTimer(uint32_t id)
     resource->RemoveTimer(id);
 }
 
+// Script enums are passed as int
+static void SetTimerPriority(uint32_t id, int priority)
+{
+    GET_RESOURCE();
+    if(!resource->SetTimerPriority(id, (Helpers::Timer::Priority)priority)) THROW_ERROR("Timer not found");
+}
+
+static uint64_t GetDeferredTimerRuns()
+{
+    GET_RESOURCE();
+    return resource->GetTimerStats().deferred;
+}
+
+static void StartCoroutine(asIScriptFunction* callback)
+{
+    GET_RESOURCE();
+    resource->GetCoroutines().Start(callback);
+    // The context of the coroutine holds its own reference
+    callback->Release();
+}
+
+static void YieldCoroutine()
+{
+    GET_RESOURCE();
+    resource->GetCoroutines().WaitForNextTick();
+}
+
+static void SleepCoroutine(uint32_t ms)
+{
+    GET_RESOURCE();
+    resource->GetCoroutines().WaitForTime(ms);
+}
+
+static void WaitForEvent(const std::string& name)
+{
+    GET_RESOURCE();
+    resource->GetCoroutines().WaitForEvent(resource->InternCustomEvent(name));
+}
+
 static uint32_t Hash(std::string& value)
 {
     return alt::ICore::Instance().Hash(value);
@@ -157,6 +244,23 @@ static void RestartResource(const std::string& name)
     alt::ICore::Instance().RestartResource(name);
 }
 
+static void HotReloadResource(const std::string& name)
+{
+    auto resource = alt::ICore::Instance().GetResource(name);
+    if(resource == nullptr)
+    {
+        THROW_ERROR("Resource not found");
+        return;
+    }
+    auto impl = dynamic_cast<AngelScriptResource*>(resource->GetImpl());
+    if(impl == nullptr)
+    {
+        THROW_ERROR("Resource is not an AngelScript resource");
+        return;
+    }
+    impl->RequestHotReload();
+}
+
 static uint32_t GetNetTime()
 {
     return alt::ICore::Instance().GetNetTime();
@@ -201,10 +305,10 @@ static std::string ReadFile(const std::string& path)
 {
     GET_RESOURCE();
     auto file = resource->ReadFile(path);
-    if(file.IsEmpty())
+    if(!file.IsValid())
     {
         THROW_ERROR("File not found");
-        return nullptr;
+        return std::string();
     }
     return file.ToString();
 }
@@ -212,42 +316,89 @@ static std::string ReadFile(const std::string& path)
 static bool FileExists(const std::string& path)
 {
     GET_RESOURCE();
-    auto file = resource->ReadFile(path);
-    return !file.IsEmpty();
+    return resource->FileExists(path);
 }
 
-static void On(const std::string& name, asIScriptFunction* handler)
+static uint32_t On(const std::string& name, asIScriptFunction* handler)
 {
     GET_RESOURCE();
-    resource->RegisterCustomEventHandler(name, handler, true);
+    return resource->RegisterCustomEventHandler(name, handler, true);
 }
 
-static void OnClient(const std::string& name, asIScriptFunction* handler)
+static uint32_t OnClient(const std::string& name, asIScriptFunction* handler)
 {
     GET_RESOURCE();
-    resource->RegisterCustomEventHandler(name, handler, false);
+    return resource->RegisterCustomEventHandler(name, handler, false);
 }
 
-static void Emit(asIScriptGeneric* gen)
+// Registers a handler that declares the types of the event args as its params, the handler is passed as funcdef handle
+static uint32_t RegisterTypedHandler(const std::string& name, void* ref, int typeId, bool local)
+{
+    GET_RESOURCE();
+    auto runtime = resource->GetRuntime();
+    auto type = runtime->GetEngine()->GetTypeInfoById(typeId);
+    if((typeId & asTYPEID_OBJHANDLE) == 0 || type == nullptr || (type->GetFlags() & asOBJ_FUNCDEF) == 0)
+    {
+        THROW_ERROR("The handler has to be a function handle");
+        return 0;
+    }
+    auto handler = *static_cast<asIScriptFunction**>(ref);
+    if(handler == nullptr)
+    {
+        THROW_ERROR("The handler is null");
+        return 0;
+    }
+
+    int firstTypeId = 0;
+    if(!local && handler->GetParamCount() > 0) handler->GetParam(0, &firstTypeId);
+    if(!local && firstTypeId != (runtime->GetPlayerTypeId() | asTYPEID_OBJHANDLE))
+    {
+        THROW_ERROR("The first param of a remote event handler has to be the Player@ that sent the event");
+        return 0;
+    }
+    std::string error;
+    if(!TypedEventArgs::ValidateHandler(runtime, handler, local ? 0 : 1, error))
+    {
+        THROW_ERROR(error.c_str());
+        return 0;
+    }
+
+    // The handle is only borrowed from the script
+    handler->AddRef();
+    return resource->RegisterCustomEventHandler(name, handler, local, true);
+}
+
+static uint32_t OnTyped(const std::string& name, void* ref, int typeId)
+{
+    return RegisterTypedHandler(name, ref, typeId, true);
+}
+
+static uint32_t OnClientTyped(const std::string& name, void* ref, int typeId)
+{
+    return RegisterTypedHandler(name, ref, typeId, false);
+}
+
+static void Off(uint32_t handlerId)
 {
     GET_RESOURCE();
-    void* ref = gen->GetArgAddress(0);
-	int typeId = 0;
-	std::string event = *static_cast<std::string*>(ref);
+    resource->RemoveEventHandler(handlerId);
+}
+
+static void Emit(asIScriptGeneric* gen)
+{
+    // The overload only has the supplied args
+    auto& event = *static_cast<std::string*>(gen->GetArgAddress(0));
     alt::MValueArgs args;
 
     for(int i = 1; i < gen->GetArgCount(); i++)
     {
-        ref = gen->GetArgAddress(i);
-        typeId = gen->GetArgTypeId(i);
-        if(typeId == resource->GetRuntime()->GetStringTypeId() && *static_cast<std::string*>(ref) == VARIADIC_ARG_INVALID) continue;
-        auto mvalue = Helpers::ValueToMValue(typeId, ref);
+        auto mvalue = Helpers::ValueToMValue(gen->GetArgTypeId(i), gen->GetArgAddress(i));
         args.Push(mvalue);
     }
     alt::ICore::Instance().TriggerLocalEvent(event, args);
 }
 
-static ModuleExtension altExtension("alt", [](asIScriptEngine* engine, DocsGenerator* docs)
+static ModuleExtension altExtension("alt", "Globals", [](asIScriptEngine* engine, DocsGenerator* docs)
 {
     // Generic
     REGISTER_GLOBAL_FUNC("uint Hash(const string &in value)", Hash, "Hashes the given string using the joaat algorithm");
@@ -270,6 +421,7 @@ static ModuleExtension altExtension("alt", [](asIScriptEngine* engine, DocsGener
     REGISTER_GLOBAL_FUNC("void StartResource(const string&in name)", StartResource, "Starts the specified resource");
     REGISTER_GLOBAL_FUNC("void StopResource(const string&in name)", StopResource, "Stops the specified resource");
     REGISTER_GLOBAL_FUNC("void RestartResource(const string&in name)", RestartResource, "Restarts the specified resource");
+    REGISTER_GLOBAL_FUNC("void HotReloadResource(const string&in name)", HotReloadResource, "Rebuilds the specified AngelScript resource on the next tick while keeping its global variables, event handlers and timers");
     REGISTER_GLOBAL_PROPERTY("string", "resourceMain", GetResourceMain);
     REGISTER_GLOBAL_PROPERTY("string", "resourceName", GetResourceName);
 
@@ -283,9 +435,19 @@ static ModuleExtension altExtension("alt", [](asIScriptEngine* engine, DocsGener
     REGISTER_GLOBAL_FUNC("void LogError(const string&in msg)", LogError, "Logs the specified message as an error to the console");
 
     // Timers
+    REGISTER_REF_CLASS("TimerToken", Helpers::TimerToken, asOBJ_REF, "Token to cancel a group of timers at once, can be reused after cancelling");
+    REGISTER_FACTORY("TimerToken", "", TimerTokenFactory);
+    REGISTER_REF_COUNTING("TimerToken", Helpers::TimerToken);
+    REGISTER_METHOD("TimerToken", "void Cancel()", Helpers::TimerToken, Cancel);
     REGISTER_FUNCDEF("void TimerCallback()", "Callback used for timers");
-    REGISTER_GLOBAL_FUNC("uint SetTimeout(TimerCallback@ callback, uint timeout)", SetTimeout, "Sets a timeout");
-    REGISTER_GLOBAL_FUNC("uint SetInterval(TimerCallback@ callback, uint interval)", SetInterval, "Sets a interval");
+    REGISTER_FUNCDEF("void TimerValueCallback(int64 value)", "Callback used for timers with a bound value");
+    REGISTER_FUNCDEF("void TimerPlayerCallback(Player@ player)", "Callback used for timers with a bound player");
+    REGISTER_GLOBAL_FUNC("uint SetTimeout(TimerCallback@ callback, uint timeout, TimerToken@ token = null)", SetTimeout, "Sets a timeout");
+    REGISTER_GLOBAL_FUNC("uint SetTimeout(TimerValueCallback@ callback, uint timeout, int64 value, TimerToken@ token = null)", SetTimeoutWithValue, "Sets a timeout, the value is passed to the callback");
+    REGISTER_GLOBAL_FUNC("uint SetTimeout(TimerPlayerCallback@ callback, uint timeout, Player@ player, TimerToken@ token = null)", SetTimeoutWithPlayer, "Sets a timeout, the player is passed to the callback");
+    REGISTER_GLOBAL_FUNC("uint SetInterval(TimerCallback@ callback, uint interval, TimerToken@ token = null)", SetInterval, "Sets a interval");
+    REGISTER_GLOBAL_FUNC("uint SetInterval(TimerValueCallback@ callback, uint interval, int64 value, TimerToken@ token = null)", SetIntervalWithValue, "Sets a interval, the value is passed to the callback");
+    REGISTER_GLOBAL_FUNC("uint SetInterval(TimerPlayerCallback@ callback, uint interval, Player@ player, TimerToken@ token = null)", SetIntervalWithPlayer, "Sets a interval, the player is passed to the callback");
     REGISTER_GLOBAL_FUNC("uint NextTick(TimerCallback@ callback)", NextTick, "Sets a next tick handler");
     REGISTER_GLOBAL_FUNC("uint EveryTick(TimerCallback@ callback)", EveryTick, "Sets a every tick handler");
     REGISTER_GLOBAL_FUNC("void ClearTimeout(uint timerId)", ClearTimer, "Clears specified timer");
@@ -293,11 +455,26 @@ static ModuleExtension altExtension("alt", [](asIScriptEngine* engine, DocsGener
     REGISTER_GLOBAL_FUNC("void ClearNextTick(uint timerId)", ClearTimer, "Clears specified timer");
     REGISTER_GLOBAL_FUNC("void ClearEveryTick(uint timerId)", ClearTimer, "Clears specified timer");
     REGISTER_GLOBAL_FUNC("void ClearTimer(uint timerId)", ClearTimer, "Clears specified timer");
+    REGISTER_ENUM("TimerPriority", "Priorities of timers, normal timers are deferred to the next ticks when the tick budget is used up");
+    REGISTER_ENUM_VALUE("TimerPriority", "NORMAL", Helpers::Timer::Priority::NORMAL);
+    REGISTER_ENUM_VALUE("TimerPriority", "HIGH", Helpers::Timer::Priority::HIGH);
+    REGISTER_GLOBAL_FUNC("void SetTimerPriority(uint timerId, TimerPriority priority)", SetTimerPriority, "Sets the priority of the specified timer");
+    REGISTER_GLOBAL_PROPERTY("uint64", "deferredTimerRuns", GetDeferredTimerRuns);
+
+    // Coroutines
+    REGISTER_FUNCDEF("void CoroutineCallback()", "Callback used for coroutines");
+    REGISTER_GLOBAL_FUNC("void StartCoroutine(CoroutineCallback@ callback)", StartCoroutine, "Starts a coroutine, it runs until it suspends itself the first time");
+    REGISTER_GLOBAL_FUNC("void Yield()", YieldCoroutine, "Suspends the current coroutine until the next tick");
+    REGISTER_GLOBAL_FUNC("void Sleep(uint ms)", SleepCoroutine, "Suspends the current coroutine for the specified time");
+    REGISTER_GLOBAL_FUNC("void WaitForEvent(const string&in event)", WaitForEvent, "Suspends the current coroutine until the specified local or remote custom event is emitted");
 
     // Events
     REGISTER_FUNCDEF("void LocalEventCallback(array<any> args)", "Event callback used for custom events");
     REGISTER_FUNCDEF("void RemoteEventCallback(Player@ player, array<any>@ args)", "Event callback used for custom events");
-    REGISTER_GLOBAL_FUNC("void On(const string&in event, LocalEventCallback@ callback)", On, "Registers an event handler for a local custom event");
-    REGISTER_GLOBAL_FUNC("void OnClient(const string&in event, RemoteEventCallback@ callback)", OnClient, "Registers an event handler for a remote custom event");
+    REGISTER_GLOBAL_FUNC("uint On(const string&in event, LocalEventCallback@ callback)", On, "Registers an event handler for a local custom event, returns the id of the handler");
+    REGISTER_GLOBAL_FUNC("uint OnClient(const string&in event, RemoteEventCallback@ callback)", OnClient, "Registers an event handler for a remote custom event, returns the id of the handler");
+    REGISTER_GLOBAL_FUNC("uint OnTyped(const string&in event, ?&in callback)", OnTyped, "Registers an event handler for a local custom event, the args are passed as the params of the handler (e.g. a 'void(int, string, Vector3f)' funcdef handle), returns the id of the handler");
+    REGISTER_GLOBAL_FUNC("uint OnClientTyped(const string&in event, ?&in callback)", OnClientTyped, "Registers an event handler for a remote custom event, the args are passed as the params after the player (e.g. a 'void(Player@, int, string)' funcdef handle), returns the id of the handler");
+    REGISTER_GLOBAL_FUNC("void Off(uint handlerId)", Off, "Removes the specified event handler, it can be called from the handler itself");
     REGISTER_VARIADIC_FUNC("void", "Emit", "string&in event", 32, Emit, "Emits a local event (Max 32 args)");
 });
@@ -1,6 +1,6 @@
 #include "baseobject.h"
 
-static ModuleExtension baseObjectExtension("alt", [](asIScriptEngine* engine, DocsGenerator* docs) {
+static ModuleExtension baseObjectExtension("alt", "BaseObject", [](asIScriptEngine* engine, DocsGenerator* docs) {
     RegisterAsBaseObject<alt::IBaseObject>(engine, docs, "BaseObject");
 
     REGISTER_ENUM("ObjectType", "Types used by base objects");
@@ -6,7 +6,7 @@ static T* Cast(alt::IEntity* entity)
     return dynamic_cast<T*>(entity);
 }
 
-static ModuleExtension entityExtension("alt", [](asIScriptEngine* engine, DocsGenerator* docs) {
+static ModuleExtension entityExtension("alt", "Entity", [](asIScriptEngine* engine, DocsGenerator* docs) {
     RegisterAsEntity<alt::IEntity>(engine, docs, "Entity");
     
     // Casts
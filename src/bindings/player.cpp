@@ -249,7 +249,7 @@ static void Emit(const std::string& event, CScriptArray* args, alt::IPlayer* pla
     alt::ICore::Instance().TriggerClientEvent(alt::Ref<alt::IPlayer>(player), event, mvalueArgs);
 }
 
-static ModuleExtension playerExtension("alt", [](asIScriptEngine* engine, DocsGenerator* docs) {
+static ModuleExtension playerExtension("alt", "Player", [](asIScriptEngine* engine, DocsGenerator* docs) {
     RegisterAsEntity<alt::IPlayer>(engine, docs, "Player");
 
     // Implicit conversion to string
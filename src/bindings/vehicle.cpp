@@ -25,7 +25,7 @@ static alt::IVehicle* VehicleFactory(uint32_t model, Vector3<float> pos, Vector3
     return vehicle.Get();
 }
 
-static ModuleExtension playerExtension("alt", [](asIScriptEngine* engine, DocsGenerator* docs) {
+static ModuleExtension playerExtension("alt", "Vehicle", [](asIScriptEngine* engine, DocsGenerator* docs) {
     RegisterAsEntity<alt::IVehicle>(engine, docs, "Vehicle");
 
     REGISTER_FACTORY("Vehicle", "uint model, Vector3f pos, Vector3f rot", VehicleFactory);
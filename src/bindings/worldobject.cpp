@@ -1,5 +1,5 @@
 #include "worldobject.h"
 
-static ModuleExtension worldObjectExtension("alt", [](asIScriptEngine* engine, DocsGenerator* docs) {
+static ModuleExtension worldObjectExtension("alt", "WorldObject", [](asIScriptEngine* engine, DocsGenerator* docs) {
     RegisterAsWorldObject<alt::IWorldObject>(engine, docs, "WorldObject");
 });
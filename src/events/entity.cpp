@@ -4,13 +4,13 @@
 using namespace Helpers;
 
 REGISTER_EVENT_HANDLER(alt::CEvent::Type::REMOVE_ENTITY_EVENT, RemoveEntity, "void", "Entity@ entity",
-[](AngelScriptResource* resource, const alt::CEvent* event, std::vector<std::pair<void*, bool>>& args) {
+[](AngelScriptResource* resource, const alt::CEvent* event) {
     auto ev = static_cast<const alt::CRemoveEntityEvent*>(event);
-    args.push_back({ev->GetEntity().Get(), false});
+    return std::make_tuple(ev->GetEntity().Get());
 });
 
 REGISTER_EVENT_HANDLER(alt::CEvent::Type::REMOVE_BASE_OBJECT_EVENT, RemoveBaseObject, "void", "BaseObject@ object",
-[](AngelScriptResource* resource, const alt::CEvent* event, std::vector<std::pair<void*, bool>>& args) {
+[](AngelScriptResource* resource, const alt::CEvent* event) {
     auto ev = static_cast<const alt::CRemoveBaseObjectEvent*>(event);
-    args.push_back({ev->GetObject().Get(), false});
+    return std::make_tuple(ev->GetObject().Get());
 });
@@ -5,28 +5,29 @@
 using namespace Helpers;
 
 REGISTER_EVENT_HANDLER(alt::CEvent::Type::RESOURCE_START, ResourceStart, "void", "const string &in resource", 
-[](AngelScriptResource* resource, const alt::CEvent* event, std::vector<std::pair<void*, bool>>& args) {
+[](AngelScriptResource* resource, const alt::CEvent* event) {
     auto ev = static_cast<const alt::CResourceStartEvent*>(event);
-    args.push_back({(void*)ev->GetResource()->GetName().CStr(), false});
+    return std::make_tuple(ev->GetResource()->GetName().ToString());
 });
 
 REGISTER_EVENT_HANDLER(alt::CEvent::Type::RESOURCE_STOP, ResourceStop, "void", "const string &in resource",
-[](AngelScriptResource* resource, const alt::CEvent* event, std::vector<std::pair<void*, bool>>& args) {
+[](AngelScriptResource* resource, const alt::CEvent* event) {
     auto ev = static_cast<const alt::CResourceStopEvent*>(event);
-    args.push_back({(void*)ev->GetResource()->GetName().CStr(), false});
+    return std::make_tuple(ev->GetResource()->GetName().ToString());
 });
 
 REGISTER_EVENT_HANDLER(alt::CEvent::Type::CONSOLE_COMMAND_EVENT, ConsoleCommand, "void", "string command, array<string> args",
-[](AngelScriptResource* resource, const alt::CEvent* event, std::vector<std::pair<void*, bool>>& args) {
+[](AngelScriptResource* resource, const alt::CEvent* event) {
     auto ev = static_cast<const alt::CConsoleCommandEvent*>(event);
 
     auto evArgs = ev->GetArgs();
     auto arr = resource->GetRuntime()->CreateStringArray(evArgs.GetSize());
     for(int i = 0; i < evArgs.GetSize(); i++)
     {
-        arr->SetValue(i, &evArgs[i].ToString());
+        auto arg = evArgs[i].ToString();
+        arr->SetValue(i, &arg);
     }
 
-    args.push_back({(void*)ev->GetName().CStr(), false});
-    args.push_back({arr, false});
+    // The handlers get a copy of the array, so it is released after all of them ran
+    return std::make_tuple(ev->GetName().ToString(), ScriptArrayArg(arr));
 });
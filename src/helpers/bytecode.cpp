@@ -0,0 +1,86 @@
+#include "bytecode.h"
+#include <cstring>
+#include <filesystem>
+
+using namespace Helpers;
+
+int BytecodeStream::Read(void* ptr, asUINT size)
+{
+    if(readPos + size > buffer.size()) return -1;
+    memcpy(ptr, buffer.data() + readPos, size);
+    readPos += size;
+    return 0;
+}
+
+int BytecodeStream::Write(const void* ptr, asUINT size)
+{
+    auto data = static_cast<const char*>(ptr);
+    buffer.insert(buffer.end(), data, data + size);
+    return 0;
+}
+
+bool BytecodeCache::ReadHeader(std::ifstream& file)
+{
+    file.read(reinterpret_cast<char*>(&header), sizeof(Header));
+    if(!file) return false;
+    return header.magic == MAGIC && header.version == VERSION;
+}
+
+bool BytecodeCache::IsUpToDate(uint64_t sourceHash, uint64_t interfaceHash)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open() || !ReadHeader(file)) return false;
+    return header.sourceHash == sourceHash && header.interfaceHash == interfaceHash;
+}
+
+bool BytecodeCache::Load(asIScriptModule* module)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file.is_open()) return false;
+
+    size_t size = file.tellg();
+    file.seekg(0);
+    if(size < sizeof(Header) || !ReadHeader(file)) return false;
+
+    BytecodeStream stream;
+    auto& buffer = stream.GetBuffer();
+    buffer.resize(size - sizeof(Header));
+    file.read(buffer.data(), buffer.size());
+    if(!file) return false;
+
+    int r = module->LoadByteCode(&stream);
+    if(r < 0)
+    {
+        Log::Warning << "Failed to load bytecode cache '" << path << "'. Error code: " << std::to_string(r) << Log::Endl;
+        return false;
+    }
+    return true;
+}
+
+bool BytecodeCache::Save(asIScriptModule* module, uint64_t sourceHash, uint64_t interfaceHash, uint32_t compileTime)
+{
+    BytecodeStream stream;
+    // Keep the debug info, otherwise exceptions would not contain line numbers
+    int r = module->SaveByteCode(&stream, false);
+    if(r < 0)
+    {
+        Log::Warning << "Failed to save bytecode of module '" << module->GetName() << "'. Error code: " << std::to_string(r) << Log::Endl;
+        return false;
+    }
+
+    std::error_code err;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), err);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+    {
+        Log::Warning << "Failed to open bytecode cache '" << path << "' for writing" << Log::Endl;
+        return false;
+    }
+
+    Header header{MAGIC, VERSION, sourceHash, interfaceHash, compileTime, 0};
+    auto& buffer = stream.GetBuffer();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(buffer.data(), buffer.size());
+    return true;
+}
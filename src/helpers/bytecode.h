@@ -0,0 +1,72 @@
+#pragma once
+
+#include "cpp-sdk/SDK.h"
+#include "Log.h"
+#include "angelscript/include/angelscript.h"
+#include <fstream>
+
+namespace Helpers
+{
+    // Memory backed stream used to save and load module bytecode
+    class BytecodeStream : public asIBinaryStream
+    {
+        std::vector<char> buffer;
+        size_t readPos = 0;
+
+    public:
+        int Read(void* ptr, asUINT size) override;
+        int Write(const void* ptr, asUINT size) override;
+
+        std::vector<char>& GetBuffer()
+        {
+            return buffer;
+        }
+    };
+
+    // On-disk cache of compiled module bytecode
+    // The cache is only used when the hash of the script sources and the hash of the
+    // registered engine interface both match the ones the bytecode was compiled with
+    class BytecodeCache
+    {
+        static const uint32_t MAGIC = 0x43425341; // 'ASBC'
+        static const uint32_t VERSION = 1;
+
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t sourceHash;
+            uint64_t interfaceHash;
+            // Time in ms it took to compile the cached bytecode
+            uint32_t compileTime;
+            // Fills the padding, so no uninitialized bytes are written to the file
+            uint32_t reserved;
+        };
+        static_assert(sizeof(Header) == 32, "The header must not contain padding");
+
+        std::string path;
+        Header header;
+
+        bool ReadHeader(std::ifstream& file);
+
+    public:
+        BytecodeCache(std::string path) : path(path) {};
+
+        // Checks whether the cache exists and was created from the same sources and engine interface
+        bool IsUpToDate(uint64_t sourceHash, uint64_t interfaceHash);
+        // Loads the cached bytecode into the (empty) module
+        bool Load(asIScriptModule* module);
+        // Saves the bytecode of the module to the cache
+        bool Save(asIScriptModule* module, uint64_t sourceHash, uint64_t interfaceHash, uint32_t compileTime);
+
+        const std::string& GetPath()
+        {
+            return path;
+        }
+        // Time in ms it took to compile the cached bytecode
+        uint32_t GetCompileTime()
+        {
+            return header.compileTime;
+        }
+    };
+}
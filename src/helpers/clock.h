@@ -0,0 +1,13 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace Helpers
+{
+    // Monotonic time in ms, used for the timers, the execution budgets and the file watcher
+    static int64_t GetTime()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
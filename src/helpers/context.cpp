@@ -0,0 +1,57 @@
+#include "context.h"
+#include "Log.h"
+
+using namespace Helpers;
+
+asIScriptContext* ContextPool::Request(bool allowNested)
+{
+    // Called by a script function of this pool, so reuse its context in a nested state
+    auto active = allowNested ? asGetActiveContext() : nullptr;
+    if(active != nullptr && active->GetEngine() == engine && active->GetUserData() == userData && active->GetState() == asEXECUTION_ACTIVE)
+    {
+        if(active->PushState() >= 0) return active;
+    }
+
+    asIScriptContext* context;
+    if(!idle.empty())
+    {
+        context = idle.back();
+        idle.pop_back();
+    }
+    else
+    {
+        context = engine->CreateContext();
+        context->SetUserData(userData);
+    }
+    return context;
+}
+
+asIScriptContext* ContextPool::Prepare(asIScriptFunction* func)
+{
+    auto context = Request();
+    int r = context->Prepare(func);
+    if(r < 0)
+    {
+        Log::Error << "Context prepare error. Error code: " << std::to_string(r) << Log::Endl;
+        Return(context);
+        return nullptr;
+    }
+    return context;
+}
+
+void ContextPool::Return(asIScriptContext* context)
+{
+    if(context->IsNested())
+    {
+        context->PopState();
+        return;
+    }
+    context->Unprepare();
+    idle.push_back(context);
+}
+
+void ContextPool::Clear()
+{
+    for(auto context : idle) context->Release();
+    idle.clear();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include "angelscript/include/angelscript.h"
+
+namespace Helpers
+{
+    // Hands out script contexts, so script functions can be called while another script function is running
+    // (e.g. an event emitted by a script that is handled synchronously)
+    // If a context of the pool is currently calling into the application, its state is pushed and the context is reused
+    class ContextPool
+    {
+        asIScriptEngine* engine = nullptr;
+        void* userData = nullptr;
+        // Unprepared contexts that can be handed out
+        std::vector<asIScriptContext*> idle;
+
+    public:
+        ContextPool() = default;
+        ContextPool(const ContextPool&) = delete;
+        ContextPool& operator=(const ContextPool&) = delete;
+        ~ContextPool()
+        {
+            Clear();
+        }
+
+        // The user data is set on all contexts of the pool
+        void Init(asIScriptEngine* engine, void* userData)
+        {
+            this->engine = engine;
+            this->userData = userData;
+        }
+
+        // Gets an unprepared context, has to be given back with Return
+        // If nesting is not allowed, a separate context is always returned
+        asIScriptContext* Request(bool allowNested = true);
+        // Gets a context prepared for the function, returns nullptr if preparing failed
+        asIScriptContext* Prepare(asIScriptFunction* func);
+        void Return(asIScriptContext* context);
+
+        // Releases all idle contexts
+        void Clear();
+    };
+}
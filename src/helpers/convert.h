@@ -3,6 +3,7 @@
 #include "cpp-sdk/SDK.h"
 #include "Log.h"
 #include "angelscript/include/angelscript.h"
+#include "angelscript/addon/scriptany/scriptany.h"
 #include "../bindings/vector3.h"
 #include "../bindings/vector2.h"
 #include "../runtime.h"
@@ -26,89 +27,73 @@ namespace Helpers
             //case alt::IMValue::Type::RGBA: return engine->GetTypeInfoByName("RGBA");
         }
     }
-    // first = typeId, second = value
-    static std::pair<int, void*> MValueToValue(AngelScriptRuntime* runtime, alt::MValueConst& val)
+    // Stores the value in the any, the values are built on the stack and copied by the any
+    // Unsupported types are stored as an empty any
+    static void MValueToAny(AngelScriptRuntime* runtime, alt::MValueConst& val, CScriptAny* any)
     {
-        int type;
-        void* valuePtr;
         switch(val->GetType())
         {
             case alt::IMValue::Type::BOOL: 
             {
-                type = asTYPEID_BOOL;
-                auto value = val.As<alt::IMValueBool>()->Value();
-                valuePtr = &value;
+                bool value = val.As<alt::IMValueBool>()->Value();
+                any->Store(&value, asTYPEID_BOOL);
                 break;
             }
             case alt::IMValue::Type::INT:
             {
-                type = asTYPEID_INT64;
-                auto value = new uint64_t(val.As<alt::IMValueInt>()->Value());
-                valuePtr = value;
+                asINT64 value = val.As<alt::IMValueInt>()->Value();
+                any->Store(value);
                 break;
             }
             case alt::IMValue::Type::UINT:
             {
                 // any doesn't support uints so we have to store it as an int64 instead
-                type = asTYPEID_INT64;
-                auto value = new int64_t(val.As<alt::IMValueUInt>()->Value());
-                valuePtr = value;
+                asINT64 value = (asINT64)val.As<alt::IMValueUInt>()->Value();
+                any->Store(value);
                 break;
             }
             case alt::IMValue::Type::DOUBLE:
             {
-                type = asTYPEID_DOUBLE;
-                auto value = new double(val.As<alt::IMValueDouble>()->Value());
-                valuePtr = value;
+                double value = val.As<alt::IMValueDouble>()->Value();
+                any->Store(value);
                 break;
             }
             case alt::IMValue::Type::STRING:
             {
-                type = runtime->GetStringTypeId();
-                auto value = new std::string(val.As<alt::IMValueString>()->Value().CStr());
-                valuePtr = value;
+                std::string value = val.As<alt::IMValueString>()->Value().ToString();
+                any->Store(&value, runtime->GetStringTypeId());
                 break;
             }
-            case alt::IMValue::Type::LIST:
-            {
-                // todo: add handle for array in custom events
-                /*typeInfo = engine->GetTypeInfoByName("array");
-                auto value = val.As<alt::IMValueList>()->Get();
-                valuePtr = &value;*/
-                break;
-            }
-            case alt::IMValue::Type::DICT:
-            {
-                // todo: add handle for dict in custom events
-                /*typeInfo = engine->GetTypeInfoByName("dict");
-                auto value = val.As<alt::IMValueUInt>()->Value();
-                valuePtr = &value;
-                break;*/
-            }
             case alt::IMValue::Type::BASE_OBJECT:
             {
-                type = runtime->GetBaseObjectTypeId();
-                auto value = val.As<alt::IMValueBaseObject>()->Value();
-                valuePtr = value.Get();
+                // Stored as handle, base objects can't be copied
+                alt::IBaseObject* value = val.As<alt::IMValueBaseObject>()->Value().Get();
+                any->Store(&value, runtime->GetBaseObjectTypeId() | asTYPEID_OBJHANDLE);
                 break;
             }
             case alt::IMValue::Type::VECTOR3:
             {
-                type = runtime->GetEngine()->GetTypeInfoByName("Vector3f")->GetTypeId();
-                auto value = val.As<alt::IMValueVector3>()->Value();
-                valuePtr = new Vector3<float>(value[0], value[1], value[2]);
+                static int vector3TypeId = runtime->GetEngine()->GetTypeIdByDecl("Vector3f");
+                auto vector = val.As<alt::IMValueVector3>()->Value();
+                Vector3<float> value(vector[0], vector[1], vector[2]);
+                any->Store(&value, vector3TypeId);
                 break;
             }
             case alt::IMValue::Type::VECTOR2:
             {
-                type = runtime->GetEngine()->GetTypeInfoByName("Vector2f")->GetTypeId();
-                auto value = val.As<alt::IMValueVector2>()->Value();
-                valuePtr = new Vector2<float>(value[0], value[1]);
+                static int vector2TypeId = runtime->GetEngine()->GetTypeIdByDecl("Vector2f");
+                auto vector = val.As<alt::IMValueVector2>()->Value();
+                Vector2<float> value(vector[0], vector[1]);
+                any->Store(&value, vector2TypeId);
+                break;
+            }
+            // todo: add handle for array and dict in custom events
+            default:
+            {
+                any->Store(nullptr, asTYPEID_VOID);
                 break;
             }
-            //case alt::IMValue::Type::RGBA: return engine->GetTypeInfoByName("RGBA");
         }
-        return {type, valuePtr};
     }
     static alt::MValue ValueToMValue(int type, void* value)
     {
@@ -0,0 +1,144 @@
+#include "coroutine.h"
+#include "../resource.h"
+#include "Log.h"
+#include <algorithm>
+
+using namespace Helpers;
+
+bool CoroutineScheduler::Start(asIScriptFunction* func)
+{
+    // A coroutine has to suspend its own context, so it can never run nested in the context of the caller
+    auto& pool = resource->GetContextPool();
+    auto context = pool.Request(false);
+    int r = context->Prepare(func);
+    if(r < 0)
+    {
+        Log::Error << "Coroutine prepare error. Error code: " << std::to_string(r) << Log::Endl;
+        pool.Return(context);
+        return false;
+    }
+    Resume(context);
+    return true;
+}
+
+void CoroutineScheduler::Resume(asIScriptContext* context)
+{
+    // Coroutines can be started by other coroutines
+    auto previous = running;
+    running = context;
+    int r = resource->Execute(context);
+    running = previous;
+
+    // The coroutine was already added to a wait queue before suspending
+    if(r == asEXECUTION_SUSPENDED) return;
+    if(r == asEXECUTION_EXCEPTION)
+    {
+        Log::Error << "An exception occured while executing a coroutine. Exception: " << Log::Endl;
+        Log::Error << GetExceptionInfo(context, alt::ICore::Instance().IsDebug()) << Log::Endl;
+    }
+    resource->GetContextPool().Return(context);
+}
+
+asIScriptContext* CoroutineScheduler::GetSuspendableContext()
+{
+    auto context = asGetActiveContext();
+    if(context == nullptr || context != running || context->IsNested())
+    {
+        if(context != nullptr) context->SetException("Only coroutines can be suspended, use StartCoroutine to start one");
+        return nullptr;
+    }
+    return context;
+}
+
+void CoroutineScheduler::WaitForNextTick()
+{
+    auto context = GetSuspendableContext();
+    if(context == nullptr) return;
+    yielded.push_back(context);
+    context->Suspend();
+}
+
+void CoroutineScheduler::WaitForTime(uint32_t ms)
+{
+    auto context = GetSuspendableContext();
+    if(context == nullptr) return;
+    sleeping.push({resource->GetTime() + ms, context});
+    context->Suspend();
+}
+
+void CoroutineScheduler::WaitForEvent(uint32_t eventId)
+{
+    auto context = GetSuspendableContext();
+    if(context == nullptr) return;
+    waitingForEvent.insert({eventId, context});
+    context->Suspend();
+}
+
+void CoroutineScheduler::Update(int64_t time)
+{
+    if(!yielded.empty())
+    {
+        // Coroutines yielding again while resuming are resumed on the next tick
+        std::vector<asIScriptContext*> resume;
+        resume.swap(yielded);
+        for(auto context : resume) Resume(context);
+    }
+
+    while(!sleeping.empty() && sleeping.top().wakeTime <= time)
+    {
+        auto context = sleeping.top().context;
+        sleeping.pop();
+        Resume(context);
+    }
+}
+
+void CoroutineScheduler::NotifyEvent(uint32_t eventId)
+{
+    auto range = waitingForEvent.equal_range(eventId);
+    if(range.first == range.second) return;
+
+    // Coroutines waiting for the same event again have to wait for the next one
+    std::vector<asIScriptContext*> resume;
+    for(auto it = range.first; it != range.second; it++) resume.push_back(it->second);
+    waitingForEvent.erase(eventId);
+    for(auto context : resume) Resume(context);
+}
+
+void CoroutineScheduler::Remove(asIScriptContext* context)
+{
+    yielded.erase(std::remove(yielded.begin(), yielded.end(), context), yielded.end());
+
+    // The queue can't remove single entries, so rebuild it without the context
+    decltype(sleeping) remaining;
+    while(!sleeping.empty())
+    {
+        if(sleeping.top().context != context) remaining.push(sleeping.top());
+        sleeping.pop();
+    }
+    sleeping.swap(remaining);
+
+    for(auto it = waitingForEvent.begin(); it != waitingForEvent.end();)
+    {
+        if(it->second == context) it = waitingForEvent.erase(it);
+        else it++;
+    }
+}
+
+void CoroutineScheduler::Clear()
+{
+    auto& pool = resource->GetContextPool();
+    auto abort = [&](asIScriptContext* context) {
+        context->Abort();
+        pool.Return(context);
+    };
+
+    for(auto context : yielded) abort(context);
+    yielded.clear();
+    while(!sleeping.empty())
+    {
+        abort(sleeping.top().context);
+        sleeping.pop();
+    }
+    for(auto& kv : waitingForEvent) abort(kv.second);
+    waitingForEvent.clear();
+}
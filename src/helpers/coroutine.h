@@ -0,0 +1,74 @@
+#pragma once
+
+#include <queue>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "angelscript/include/angelscript.h"
+
+class AngelScriptResource;
+namespace Helpers
+{
+    // Runs script functions as coroutines, which can suspend themselves (script functions Yield, Sleep and WaitForEvent)
+    // and are resumed from the resource tick
+    // Works like the coroutines of the contextmgr add-on, but per resource and with a wait queue instead of polling every script
+    class CoroutineScheduler
+    {
+        struct SleepingCoroutine
+        {
+            int64_t wakeTime;
+            asIScriptContext* context;
+
+            bool operator>(const SleepingCoroutine& other) const
+            {
+                return wakeTime > other.wakeTime;
+            }
+        };
+
+        AngelScriptResource* resource;
+        // The coroutine that is currently executing, only it can suspend itself
+        asIScriptContext* running = nullptr;
+
+        // Resumed on the next tick
+        std::vector<asIScriptContext*> yielded;
+        // Ordered by wake time, so only the earliest ones have to be checked each tick
+        std::priority_queue<SleepingCoroutine, std::vector<SleepingCoroutine>, std::greater<SleepingCoroutine>> sleeping;
+        // key = id of the interned custom event name
+        std::unordered_multimap<uint32_t, asIScriptContext*> waitingForEvent;
+
+        void Resume(asIScriptContext* context);
+        // Returns the running coroutine, or sets a script exception if the caller is no coroutine
+        asIScriptContext* GetSuspendableContext();
+
+    public:
+        CoroutineScheduler(AngelScriptResource* resource) : resource(resource) {};
+
+        // Starts the function as a new coroutine, it runs until it suspends itself for the first time
+        bool Start(asIScriptFunction* func);
+
+        // Suspends the calling coroutine until the next tick
+        void WaitForNextTick();
+        // Suspends the calling coroutine until the time (in ms) has passed
+        void WaitForTime(uint32_t ms);
+        // Suspends the calling coroutine until the custom event is emitted
+        void WaitForEvent(uint32_t eventId);
+
+        // Resumes the coroutines that yielded or finished sleeping
+        void Update(int64_t time);
+        // Resumes the coroutines waiting for the custom event
+        void NotifyEvent(uint32_t eventId);
+
+        bool IsWaitingForEvent(uint32_t eventId)
+        {
+            return waitingForEvent.count(eventId) != 0;
+        }
+        size_t GetCount()
+        {
+            return yielded.size() + sleeping.size() + waitingForEvent.size();
+        }
+        // Removes the coroutine from the wait queues without resuming it, used when its context gets aborted
+        void Remove(asIScriptContext* context);
+        // Aborts all suspended coroutines
+        void Clear();
+    };
+}
@@ -13,13 +13,21 @@
 
 #define PAD_SPACE "    "
 
+// Pushes the documentation of a registered declaration
+// Compiled out of the module, the docs are generated by the separate 'angelscript-docs' target
+#ifdef AS_GENERATE_DOCUMENTATION
+#define DOCS_PUSH(call) if(docs != nullptr) docs->call
+#else
+#define DOCS_PUSH(call)
+#endif
+
 // The whole docs generator is a mess, but it does the job
 
 namespace Helpers
 {
+    #ifdef AS_GENERATE_DOCUMENTATION
     class DocsGenerator
     {
-        #ifdef AS_GENERATE_DOCUMENTATION
         std::string module;
         std::vector<std::pair<std::string, std::string>> declarations;
         std::vector<std::pair<std::string, std::string>> variables;
@@ -27,78 +35,68 @@ namespace Helpers
         std::vector<std::pair<std::string, std::string>> eventDeclarations;
         std::vector<std::pair<std::string, std::string>> objectTypes;
         std::vector<std::pair<std::string, std::string>> enumTypes;
-        std::unordered_multimap<std::string, std::pair<std::string, int>> enumValues;
-        std::unordered_multimap<std::string, std::string> objectDeclarations;
-        std::unordered_multimap<std::string, std::string> objectConstructors;
-        std::unordered_multimap<std::string, std::string> objectMethods;
-        #endif
+        // key = enum or object name, so the generator can look up the entries of a type directly
+        std::unordered_map<std::string, std::vector<std::pair<std::string, int>>> enumValues;
+        std::unordered_map<std::string, std::vector<std::string>> objectDeclarations;
+        std::unordered_map<std::string, std::vector<std::string>> objectConstructors;
+        std::unordered_map<std::string, std::vector<std::string>> objectMethods;
+
+        template<typename T>
+        static const std::vector<T>& GetEntries(const std::unordered_map<std::string, std::vector<T>>& map, const std::string& key)
+        {
+            static const std::vector<T> empty;
+            auto it = map.find(key);
+            if(it == map.end()) return empty;
+            return it->second;
+        }
+
     public:
         DocsGenerator(std::string module) : module(module) {};
 
         void PushDeclaration(std::string decl, std::string desc)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
             declarations.push_back(std::pair(decl, desc));
-            #endif
         }
         void PushVariable(std::string type, std::string prop)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
             variables.push_back({type, prop});
-            #endif
         }
         void PushFuncDef(std::string funcdef, std::string desc)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
             funcDefs.push_back(std::pair(funcdef, desc));
-            #endif
         }
         void PushEventDeclaration(std::string funcDef, std::string globalFunc)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
             eventDeclarations.push_back(std::pair(funcDef.insert(0, "funcdef "), globalFunc));
-            #endif
         }
         void PushObjectType(std::string name, std::string desc)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
             objectTypes.push_back(std::pair(name, desc));
-            #endif
         }
         void PushObjectProperty(std::string object, std::string propertyDecl)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
-            objectDeclarations.insert({object, propertyDecl});
-            #endif
+            objectDeclarations[object].push_back(propertyDecl);
         }
         void PushObjectConstructor(std::string object, std::string constructorDecl)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
-            objectConstructors.insert({object, constructorDecl});
-            #endif
+            objectConstructors[object].push_back(constructorDecl);
         }
         void PushObjectMethod(std::string object, std::string methodDecl)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
-            objectMethods.insert({object, methodDecl});
-            #endif
+            objectMethods[object].push_back(methodDecl);
         }
         void PushEnumValue(std::string enumName, std::string name, int value)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
-            enumValues.insert({enumName, {name, value}});
-            #endif
+            enumValues[enumName].push_back({name, value});
         }
         void PushEnumType(std::string name, std::string desc)
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
             enumTypes.push_back({name, desc});
-            #endif
         }
 
-        void Generate()
+        // Writes the docs to '<outputDir><module>Docs.as'
+        void Generate(std::string outputDir = "")
         {
-            #ifdef AS_GENERATE_DOCUMENTATION
             std::stringstream stream;
 
             // Add generation date to top of file
@@ -112,7 +110,7 @@ namespace Helpers
 
             // Add func defs
             stream << PAD_SPACE << "// ********** Funcdefs **********" << "\n";
-            for(auto def : funcDefs)
+            for(auto& def : funcDefs)
             {
                 stream << "\n";
                 stream << PAD_SPACE << "// " << def.second << "\n";
@@ -123,16 +121,15 @@ namespace Helpers
 
             // Add enums
             stream << PAD_SPACE << "// ********** Enums **********" << "\n";
-            for(auto enumType : enumTypes)
+            for(auto& enumType : enumTypes)
             {
                 stream << "\n";
                 stream << PAD_SPACE << "// " << enumType.second << "\n";
                 stream << PAD_SPACE << "enum " << enumType.first << "\n";
                 stream << PAD_SPACE << "{" << "\n";
-                for(auto value : enumValues)
+                for(auto& value : GetEntries(enumValues, enumType.first))
                 {
-                    if(value.first != enumType.first) continue;
-                    stream << PAD_SPACE << PAD_SPACE << value.second.first << " = " << std::to_string(value.second.second) << ",\n";
+                    stream << PAD_SPACE << PAD_SPACE << value.first << " = " << std::to_string(value.second) << ",\n";
                 }
                 stream << PAD_SPACE << "};" << "\n";
             }
@@ -141,7 +138,7 @@ namespace Helpers
 
             // Add variables
             stream << PAD_SPACE << "// ********** Global variables **********" << "\n";
-            for(auto variable : variables)
+            for(auto& variable : variables)
             {
                 stream << "\n";
                 stream << PAD_SPACE << variable.first << " " << variable.second << ";" << "\n";
@@ -151,7 +148,7 @@ namespace Helpers
 
             // Add function declarations
             stream << PAD_SPACE << "// ********** Functions **********" << "\n";
-            for(auto decl : declarations)
+            for(auto& decl : declarations)
             {
                 stream << "\n";
                 stream << PAD_SPACE << "// " << decl.second << "\n";
@@ -162,7 +159,7 @@ namespace Helpers
 
             // Add event declarations
             stream << PAD_SPACE << "// ********** Events **********" << "\n";
-            for(auto decl : eventDeclarations)
+            for(auto& decl : eventDeclarations)
             {
                 stream << "\n";
                 stream << PAD_SPACE << decl.first << ";" << "\n";
@@ -173,27 +170,24 @@ namespace Helpers
 
             // Add object types
             stream << PAD_SPACE << "// ********** Objects **********\n";
-            for(auto obj : objectTypes)
+            for(auto& obj : objectTypes)
             {
                 stream << "\n";
                 stream << PAD_SPACE << "// " << obj.second << "\n";
                 stream << PAD_SPACE << "class " << obj.first << "\n";
                 stream << PAD_SPACE << "{\n";
-                for(auto kv : objectDeclarations)
+                for(auto& decl : GetEntries(objectDeclarations, obj.first))
                 {
-                    if(kv.first != obj.first) continue;
-                    stream << PAD_SPACE << PAD_SPACE << kv.second << ";\n";
+                    stream << PAD_SPACE << PAD_SPACE << decl << ";\n";
                 }
                 stream << "\n";
-                for(auto kv : objectConstructors)
+                for(auto& decl : GetEntries(objectConstructors, obj.first))
                 {
-                    if(kv.first != obj.first) continue;
-                    stream << PAD_SPACE << PAD_SPACE << obj.first << "(" << kv.second << ");\n"; 
+                    stream << PAD_SPACE << PAD_SPACE << obj.first << "(" << decl << ");\n";
                 }
-                for(auto kv : objectMethods)
+                for(auto& decl : GetEntries(objectMethods, obj.first))
                 {
-                    if(kv.first != obj.first) continue;
-                    stream << PAD_SPACE << PAD_SPACE << kv.second << ";\n";
+                    stream << PAD_SPACE << PAD_SPACE << decl << ";\n";
                 }
                 stream << PAD_SPACE << "};\n";
             }
@@ -203,10 +197,13 @@ namespace Helpers
 
             // Write the docs to file
             std::ofstream file;
-            file.open(module.append("Docs.as"));
+            file.open(outputDir + module + "Docs.as");
             file << stream.str();
             file.close();
-            #endif
         }
     };
+    #else
+    // Only available when building the docs generator
+    class DocsGenerator;
+    #endif
 }
@@ -2,4 +2,5 @@
 
 using namespace Helpers;
 
-std::unordered_map<alt::CEvent::Type, Event*> Event::all = std::unordered_map<alt::CEvent::Type, Event*>();
+// Zero initialized before any event registers itself, so it doesn't depend on the static initialization order
+std::array<Event*, (size_t)alt::CEvent::Type::SIZE> Event::all;
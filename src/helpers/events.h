@@ -1,85 +1,227 @@
 #pragma once
 
+#include <array>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include "cpp-sdk/SDK.h"
 #include "Log.h"
 #include "angelscript/include/angelscript.h"
+#include "angelscript/addon/scriptarray/scriptarray.h"
 #include "../resource.h"
 #include "docs.h"
 #include "module.h"
+#include "handlers.h"
 
 // Registers a new event handler and creates a wrapper function for registering it
+// The args getter returns a tuple with the args of the event, in the order of the declaration
 #define REGISTER_EVENT_HANDLER(type, name, returnType, decl, argsGetter) \
-    static void On##name##(asIScriptFunction* callback) { \
+    REGISTER_EVENT_HANDLER_WITH_POLICY(type, name, returnType, decl, EventCombinePolicy::FIRST_FALSE_CANCELS, argsGetter)
+
+// Same as REGISTER_EVENT_HANDLER, the policy decides how the return values of the handlers of a bool event are combined
+#define REGISTER_EVENT_HANDLER_WITH_POLICY(type, name, returnType, decl, policy, argsGetter) \
+    static uint32_t On##name##(asIScriptFunction* callback, int32_t priority) { \
         GET_RESOURCE(); \
-        resource->RegisterEventHandler(type, callback); \
+        return resource->RegisterEventHandler(type, callback, priority); \
     } \
-    static Event Event##name##(type, returnType, decl, argsGetter, [](asIScriptEngine* engine, DocsGenerator* docs) { \
-        std::stringstream funcDef; \
-        funcDef << returnType" " << #name << "Callback(" << decl << ")"; \
-        engine->RegisterFuncdef(funcDef.str().c_str()); \
-        std::stringstream globalFunc; \
-        globalFunc << "void On" << #name << "(" << #name << "Callback@ callback)"; \
-        engine->RegisterGlobalFunction(globalFunc.str().c_str(), asFUNCTION(On##name##), asCALL_CDECL); \
-        docs->PushEventDeclaration(funcDef.str(), globalFunc.str()); \
+    static TypedEvent Event##name##(type, #name, returnType, decl, policy, false, argsGetter, [](asIScriptEngine* engine, DocsGenerator* docs) { \
+        RegisterEventFunction(engine, docs, returnType, #name, decl, asFUNCTION(On##name##)); \
+    });
+
+// Registers a void event like REGISTER_EVENT_HANDLER, scripts can opt in to cancel it by registering their handler
+// with On<name>Cancellable instead, these handlers return bool and are combined with the policy of the event
+#define REGISTER_CANCELLABLE_EVENT_HANDLER(type, name, decl, argsGetter) \
+    static uint32_t On##name##(asIScriptFunction* callback, int32_t priority) { \
+        GET_RESOURCE(); \
+        return resource->RegisterEventHandler(type, callback, priority); \
+    } \
+    static TypedEvent Event##name##(type, #name, "void", decl, EventCombinePolicy::FIRST_FALSE_CANCELS, true, argsGetter, [](asIScriptEngine* engine, DocsGenerator* docs) { \
+        RegisterEventFunction(engine, docs, "void", #name, decl, asFUNCTION(On##name##)); \
+        RegisterEventFunction(engine, docs, "bool", #name "Cancellable", decl, asFUNCTION(On##name##)); \
     });
 
 namespace Helpers
 {
     using CallbacksGetter = std::vector<asIScriptFunction*>(*)(AngelScriptResource* resource, const alt::CEvent* event, std::string name);
-    // args.pair.first = pointer to object, args.pair.second = boolean whether the value is a primitive
-    using ArgsGetter = void(*)(AngelScriptResource* resource, const alt::CEvent* event, std::vector<std::pair<void*, bool>>& args);
     using RegisterCallback = void(*)(asIScriptEngine* engine, DocsGenerator* docs);
 
+    // Registers the funcdef '<name>Callback' and the function 'On<name>' that registers a handler with it
+    static void RegisterEventFunction(asIScriptEngine* engine, DocsGenerator* docs, const char* returnType, const char* name, const char* decl, const asSFuncPtr& func)
+    {
+        std::stringstream funcDef;
+        funcDef << returnType << " " << name << "Callback(" << decl << ")";
+        engine->RegisterFuncdef(funcDef.str().c_str());
+        std::stringstream globalFunc;
+        globalFunc << "uint On" << name << "(" << name << "Callback@ callback, int priority = 0)";
+        engine->RegisterGlobalFunction(globalFunc.str().c_str(), func, asCALL_CDECL);
+        DOCS_PUSH(PushEventDeclaration(funcDef.str(), globalFunc.str()));
+    }
+
+    // Script array passed as event arg, released after all handlers ran
+    class ScriptArrayArg
+    {
+        CScriptArray* array;
+
+    public:
+        ScriptArrayArg(CScriptArray* array) : array(array) {};
+        ScriptArrayArg(ScriptArrayArg&& other) : array(other.array)
+        {
+            other.array = nullptr;
+        }
+        ScriptArrayArg(const ScriptArrayArg&) = delete;
+        ~ScriptArrayArg()
+        {
+            if(array != nullptr) array->Release();
+        }
+
+        CScriptArray* Get() const
+        {
+            return array;
+        }
+    };
+
+    // Sets the event arg with the setter matching its type
+    template<typename T>
+    static void SetEventArg(asIScriptContext* context, asUINT index, const T& value)
+    {
+        if constexpr(std::is_same_v<T, bool>) context->SetArgByte(index, value);
+        else if constexpr(std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            if constexpr(sizeof(T) <= 4) context->SetArgDWord(index, (asDWORD)value);
+            else context->SetArgQWord(index, (asQWORD)value);
+        }
+        else if constexpr(std::is_same_v<T, float>) context->SetArgFloat(index, value);
+        else if constexpr(std::is_same_v<T, double>) context->SetArgDouble(index, value);
+        // Handles, e.g. Player@
+        else if constexpr(std::is_pointer_v<T>) context->SetArgObject(index, (void*)value);
+        else if constexpr(std::is_same_v<T, ScriptArrayArg>) context->SetArgObject(index, value.Get());
+        // Value types (e.g. string, Vector3f) are copied by the context
+        else context->SetArgObject(index, (void*)&value);
+    }
+
+    template<typename Tuple, size_t... Index>
+    static void SetEventArgs(asIScriptContext* context, const Tuple& args, std::index_sequence<Index...>)
+    {
+        (SetEventArg(context, (asUINT)Index, std::get<Index>(args)), ...);
+    }
+
     class Event
     {
-        static std::unordered_map<alt::CEvent::Type, Event*> all;
+        // Indexed by the event type
+        static std::array<Event*, (size_t)alt::CEvent::Type::SIZE> all;
 
+        const char* name;
         const char* callbackDecl;
         const char* returnType;
-        ArgsGetter argsGetter;
         RegisterCallback registerCallback;
 
+    protected:
+        alt::CEvent::Type type;
+        // Determined once from the return type instead of on every event
+        EventReturnKind returnKind;
+        // Used unless the resource sets another policy with '#pragma eventpolicy'
+        EventCombinePolicy combinePolicy;
+
     public:
         Event(
             alt::CEvent::Type type, 
+            const char* name,
             const char* returnType,
             const char* callbackDecl, 
-            ArgsGetter argsGetter,
+            EventCombinePolicy combinePolicy,
+            bool cancellable,
             RegisterCallback registerCallback
         ) : 
+            name(name),
             callbackDecl(callbackDecl),
             returnType(returnType),
-            argsGetter(argsGetter),
-            registerCallback(registerCallback)
+            registerCallback(registerCallback),
+            type(type),
+            returnKind(cancellable || strcmp(returnType, "bool") == 0 ? EventReturnKind::BOOL : EventReturnKind::VOID),
+            combinePolicy(combinePolicy)
         {
-            all.insert({type, this});
+            all[(size_t)type] = this;
         };
 
-        std::vector<std::pair<void*, bool>> GetArgs(AngelScriptResource* resource, const alt::CEvent* event)
+        // Calls the handlers with the args of the event, returns the result of the event
+        virtual bool Handle(AngelScriptResource* resource, const alt::CEvent* event, EventHandlerList& handlers) = 0;
+
+        alt::CEvent::Type GetType()
         {
-            std::vector<std::pair<void*, bool>> args;
-            argsGetter(resource, event, args);
-            return args;
+            return type;
+        }
+        const char* GetName()
+        {
+            return name;
         }
-
         const char* GetReturnType()
         {
             return returnType;
         }
+        EventReturnKind GetReturnKind()
+        {
+            return returnKind;
+        }
+        EventCombinePolicy GetCombinePolicy()
+        {
+            return combinePolicy;
+        }
 
         static Event* GetEvent(alt::CEvent::Type type)
         {
-            auto event = all.find(type);
-            if(event == all.end()) return nullptr;
-            return event->second;
+            if((size_t)type >= all.size()) return nullptr;
+            return all[(size_t)type];
+        }
+        // Gets the event by the name used in its On* function (e.g. 'WeaponDamage'), returns nullptr if not found
+        static Event* GetEvent(const std::string& name)
+        {
+            for(auto event : all)
+            {
+                if(event != nullptr && name == event->name) return event;
+            }
+            return nullptr;
         }
 
         static void RegisterAll(asIScriptEngine* engine, DocsGenerator* docs)
         {
             for(auto event : all)
             {
-                event.second->registerCallback(engine, docs);
+                if(event != nullptr) event->registerCallback(engine, docs);
             }
         }
     };
-}
\ No newline at end of file
+
+    // Event whose args are built by the getter as a tuple on the stack, the arg setters are generated from the tuple types
+    template<typename ArgsGetter>
+    class TypedEvent : public Event
+    {
+        ArgsGetter argsGetter;
+
+    public:
+        TypedEvent(
+            alt::CEvent::Type type,
+            const char* name,
+            const char* returnType,
+            const char* callbackDecl,
+            EventCombinePolicy combinePolicy,
+            bool cancellable,
+            ArgsGetter argsGetter,
+            RegisterCallback registerCallback
+        ) :
+            Event(type, name, returnType, callbackDecl, combinePolicy, cancellable, registerCallback),
+            argsGetter(argsGetter)
+        {
+        };
+
+        bool Handle(AngelScriptResource* resource, const alt::CEvent* event, EventHandlerList& handlers) override
+        {
+            auto args = argsGetter(resource, event);
+            using Args = decltype(args);
+            auto policy = resource->GetEventCombinePolicy(type, combinePolicy);
+            return resource->CallEventHandlers(handlers, returnKind, policy, [](asIScriptContext* context, const void* frame) {
+                SetEventArgs(context, *static_cast<const Args*>(frame), std::make_index_sequence<std::tuple_size_v<Args>>());
+            }, &args);
+        }
+    };
+}
@@ -0,0 +1,136 @@
+#include "file.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Helpers;
+
+File::File(File&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+File& File::operator=(File&& other) noexcept
+{
+    if(this == &other) return *this;
+    Unmap();
+    valid = other.valid;
+    mapped = other.mapped;
+    size = other.size;
+    buffer = std::move(other.buffer);
+    data = mapped ? other.data : buffer.data();
+
+    other.data = nullptr;
+    other.size = 0;
+    other.valid = false;
+    other.mapped = false;
+    return *this;
+}
+
+File::~File()
+{
+    Unmap();
+}
+
+File File::Open(alt::IResource* resource, const std::string& path, bool copy)
+{
+    File file;
+    auto package = resource->GetPackage();
+    if(!package->FileExists(path)) return file;
+
+    // Map the file directly from the resource directory if possible,
+    // so the content does not have to be copied into a buffer first
+    if(copy || !file.Map(resource->GetPath().ToString() + "/" + path)) file.Read(package, path);
+    return file;
+}
+
+bool File::Map(const std::string& path)
+{
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(handle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(handle, &fileSize))
+    {
+        CloseHandle(handle);
+        return false;
+    }
+    if(fileSize.QuadPart == 0)
+    {
+        CloseHandle(handle);
+        valid = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);
+    if(mapping == NULL) return false;
+    // The view keeps the mapping alive, so the handle can be closed right away
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if(view == NULL) return false;
+
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+    if(info.st_size == 0)
+    {
+        close(fd);
+        valid = true;
+        return true;
+    }
+
+    void* view = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file descriptor is closed
+    close(fd);
+    if(view == MAP_FAILED) return false;
+
+    size = (size_t)info.st_size;
+#endif
+    data = static_cast<const char*>(view);
+    valid = true;
+    mapped = true;
+    return true;
+}
+
+bool File::Read(alt::IPackage* package, const std::string& path)
+{
+    alt::IPackage::File* pkgFile = package->OpenFile(path);
+    if(pkgFile == nullptr) return false;
+
+    buffer.resize(package->GetFileSize(pkgFile));
+    // The file can be shorter than reported if it was truncated in between
+    buffer.resize(package->ReadFile(pkgFile, buffer.data(), buffer.size()));
+    package->CloseFile(pkgFile);
+
+    data = buffer.data();
+    size = buffer.size();
+    valid = true;
+    return true;
+}
+
+void File::Unmap()
+{
+    if(!mapped) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<char*>(data), size);
+#endif
+    data = nullptr;
+    mapped = false;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "cpp-sdk/SDK.h"
+#include <string>
+#include <vector>
+
+namespace Helpers
+{
+    // Read-only view of a resource file
+    // Files of resources that are stored in a directory on disk are memory mapped,
+    // otherwise the content is read from the resource package
+    // Files that can change while they are open have to be copied, truncating a mapped file makes reads of it crash (SIGBUS)
+    class File
+    {
+        const char* data = nullptr;
+        size_t size = 0;
+        bool valid = false;
+        bool mapped = false;
+        // Owns the content when the file could not be mapped
+        std::vector<char> buffer;
+
+        bool Map(const std::string& path);
+        bool Read(alt::IPackage* package, const std::string& path);
+        void Unmap();
+
+    public:
+        File() = default;
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+        File(File&& other) noexcept;
+        File& operator=(File&& other) noexcept;
+        ~File();
+
+        // Opens the file of the resource, check IsValid() to see if the file exists
+        // If copy is set, the content is always read into a buffer instead of mapping the file
+        static File Open(alt::IResource* resource, const std::string& path, bool copy = false);
+
+        bool IsValid() const
+        {
+            return valid;
+        }
+        bool IsMapped() const
+        {
+            return mapped;
+        }
+        // Never returns nullptr, empty files return an empty string
+        const char* GetData() const
+        {
+            return size == 0 ? "" : data;
+        }
+        size_t GetSize() const
+        {
+            return size;
+        }
+        std::string ToString() const
+        {
+            return std::string(GetData(), size);
+        }
+    };
+}
@@ -0,0 +1,114 @@
+#include "handlers.h"
+#include "hash.h"
+#include "Log.h"
+#include <algorithm>
+
+using namespace Helpers;
+
+uint32_t EventHandlerSlots::Allocate(EventHandlerList* list, uint32_t index)
+{
+    uint32_t slot = slots.Allocate({list, index});
+    if(slot == slots.INVALID_SLOT)
+    {
+        Log::Error << "Failed to add event handler, the max amount of " << std::to_string(slots.MAX_INDEX + 1) << " handlers is reached" << Log::Endl;
+    }
+    return slot;
+}
+
+bool EventHandlerSlots::Remove(uint32_t id)
+{
+    uint32_t slot = slots.Find(id);
+    if(slot == slots.INVALID_SLOT) return false;
+    slots[slot].list->RemoveAt(slots[slot].index);
+    return true;
+}
+
+uint32_t EventHandlerList::Add(asIScriptFunction* callback, int32_t priority)
+{
+    uint32_t index = (uint32_t)entries.size();
+    if(running == 0)
+    {
+        // After all handlers with the same or a higher priority
+        auto it = std::upper_bound(entries.begin(), entries.end(), priority, [](int32_t priority, const Entry& entry) {
+            return priority > entry.priority;
+        });
+        index = (uint32_t)(it - entries.begin());
+    }
+    // Appended while running, the order is restored after the run
+    else unsorted = true;
+
+    uint32_t slot = slots->Allocate(this, index);
+    if(slot == EventHandlerSlots::INVALID_SLOT)
+    {
+        callback->Release();
+        return 0;
+    }
+    entries.insert(entries.begin() + index, {callback, priority, slot});
+    UpdateSlots(index + 1);
+    return slots->GetId(slot);
+}
+
+void EventHandlerList::RemoveAt(uint32_t index)
+{
+    auto& entry = entries[index];
+    entry.callback->Release();
+    entry.callback = nullptr;
+    slots->Free(entry.slot);
+    removed++;
+
+    if(running == 0 && removed * 2 > entries.size()) Compact();
+}
+
+void EventHandlerList::UpdateSlots(size_t start)
+{
+    for(size_t i = start; i < entries.size(); i++)
+    {
+        if(entries[i].callback != nullptr) slots->slots[entries[i].slot].index = (uint32_t)i;
+    }
+}
+
+void EventHandlerList::Compact()
+{
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry& entry) { return entry.callback == nullptr; }), entries.end());
+    if(unsorted)
+    {
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.priority > b.priority; });
+        unsorted = false;
+    }
+    removed = 0;
+    UpdateSlots(0);
+}
+
+void EventHandlerList::Clear()
+{
+    for(auto& entry : entries)
+    {
+        if(entry.callback == nullptr) continue;
+        entry.callback->Release();
+        slots->Free(entry.slot);
+    }
+    entries.clear();
+    removed = 0;
+    unsorted = false;
+}
+
+uint32_t EventNameTable::Intern(std::string_view name)
+{
+    uint32_t id = Find(name);
+    if(id != INVALID_ID) return id;
+
+    id = (uint32_t)names.size();
+    names.emplace_back(name);
+    ids.insert({Hash64(name.data(), name.size()), id});
+    return id;
+}
+
+uint32_t EventNameTable::Find(std::string_view name) const
+{
+    auto range = ids.equal_range(Hash64(name.data(), name.size()));
+    for(auto it = range.first; it != range.second; it++)
+    {
+        if(names[it->second] == name) return it->second;
+    }
+    return INVALID_ID;
+}
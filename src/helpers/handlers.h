@@ -0,0 +1,184 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "angelscript/include/angelscript.h"
+#include "slots.h"
+
+namespace Helpers
+{
+    // What the handlers of an event return, determined once from the declaration
+    enum class EventReturnKind
+    {
+        VOID,
+        BOOL
+    };
+
+    // How the return values of the handlers of a bool event are combined into the result of the event
+    enum class EventCombinePolicy
+    {
+        // The first handler returning false cancels the event, the remaining handlers don't run
+        // Handlers returning true don't end the event, so every handler can still cancel it
+        FIRST_FALSE_CANCELS,
+        // All handlers run, the event is cancelled if any of them returned false
+        ALL_MUST_AGREE,
+        // All handlers run, the value of the last one is the result
+        LAST_WINS
+    };
+
+    class EventHandlerList;
+
+    // Generational slots of all event handlers of a resource, they map the id of a handler to its position
+    // So a handler can be removed by its id without searching the lists
+    class EventHandlerSlots
+    {
+        struct Handler
+        {
+            EventHandlerList* list = nullptr;
+            // Position in the entries of the list
+            uint32_t index = 0;
+        };
+
+        using Slots = GenerationalSlots<Handler, 20, 12>;
+        Slots slots;
+
+        friend class EventHandlerList;
+
+    public:
+        static const uint32_t INVALID_SLOT = Slots::INVALID_SLOT;
+
+        // Returns the slot, or INVALID_SLOT if there is no space left
+        uint32_t Allocate(EventHandlerList* list, uint32_t index);
+        void Free(uint32_t slot)
+        {
+            slots.Free(slot);
+        }
+        uint32_t GetId(uint32_t slot)
+        {
+            return slots.GetId(slot);
+        }
+
+        // Removes the handler and releases its callback, returns false if it was already removed
+        bool Remove(uint32_t id);
+    };
+
+    // Script handlers of an event, ordered by their priority
+    // Handlers with a higher priority run first, handlers with the same priority in the order they were added
+    // Removed handlers are left as empty entries and compacted once enough of them piled up, so removing is O(1)
+    // Handlers can be added and removed while the handlers run, added ones only run starting with the next event
+    class EventHandlerList
+    {
+        struct Entry
+        {
+            asIScriptFunction* callback;
+            int32_t priority;
+            uint32_t slot;
+        };
+
+        EventHandlerSlots* slots;
+        std::vector<Entry> entries;
+        uint32_t removed = 0;
+        // Depth of the runs, an event can be triggered again by one of its handlers
+        uint32_t running = 0;
+        // Handlers added while running are appended and sorted in after the run
+        bool unsorted = false;
+
+        void UpdateSlots(size_t start);
+        // Removes the empty entries and restores the order
+        void Compact();
+
+        friend class EventHandlerSlots;
+        void RemoveAt(uint32_t index);
+
+    public:
+        EventHandlerList(EventHandlerSlots* slots = nullptr) : slots(slots) {};
+        EventHandlerList(const EventHandlerList&) = delete;
+        ~EventHandlerList()
+        {
+            Clear();
+        }
+
+        void Init(EventHandlerSlots* slots)
+        {
+            this->slots = slots;
+        }
+
+        // Takes over the reference to the callback, returns the id of the handler or 0 if there is no space left
+        uint32_t Add(asIScriptFunction* callback, int32_t priority);
+        void Clear();
+
+        bool IsEmpty()
+        {
+            return entries.size() == removed;
+        }
+
+        // Calls the function for every handler until it returns false
+        template<typename Func>
+        void Run(Func call)
+        {
+            running++;
+            size_t count = entries.size();
+            for(size_t i = 0; i < count; i++)
+            {
+                // The entries can be reallocated by the call, so don't keep a reference
+                asIScriptFunction* callback = entries[i].callback;
+                if(callback != nullptr && !call(callback)) break;
+            }
+            running--;
+            if(running == 0 && (unsorted || removed * 2 > entries.size())) Compact();
+        }
+
+        // Calls the function with a reference to every callback, the callback can be replaced
+        // If it is set to nullptr, the handler is removed
+        template<typename Func>
+        void ForEach(Func func)
+        {
+            for(uint32_t i = 0; i < entries.size(); i++)
+            {
+                if(entries[i].callback == nullptr) continue;
+                func(entries[i].callback);
+                if(entries[i].callback == nullptr)
+                {
+                    slots->Free(entries[i].slot);
+                    removed++;
+                }
+            }
+            if(running == 0 && removed != 0) Compact();
+        }
+    };
+
+    // Interns custom event names to ids at registration, so dispatching an event only hashes its name once
+    // and the handlers and waiting coroutines are looked up by the id
+    class EventNameTable
+    {
+        // Indexed by the id
+        std::vector<std::string> names;
+        // key = hash of the name, names with the same hash are told apart by comparing them
+        std::unordered_multimap<uint64_t, uint32_t> ids;
+
+    public:
+        static const uint32_t INVALID_ID = UINT32_MAX;
+
+        // Returns the id of the name, adds it if it is not interned yet
+        uint32_t Intern(std::string_view name);
+        // Returns INVALID_ID if the name is not interned, doesn't allocate
+        uint32_t Find(std::string_view name) const;
+
+        const std::string& GetName(uint32_t id) const
+        {
+            return names[id];
+        }
+        size_t GetCount() const
+        {
+            return names.size();
+        }
+        void Clear()
+        {
+            names.clear();
+            ids.clear();
+        }
+    };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace Helpers
+{
+    static const uint64_t HASH64_OFFSET_BASIS = 14695981039346656037ULL;
+    static const uint64_t HASH64_PRIME = 1099511628211ULL;
+
+    // Hashes the given data using the 64-bit FNV-1a algorithm
+    // Unlike std::hash the result is stable across runs, so it can be stored on disk
+    static uint64_t Hash64(const void* data, size_t size, uint64_t hash = HASH64_OFFSET_BASIS)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for(size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= HASH64_PRIME;
+        }
+        return hash;
+    }
+
+    static uint64_t Hash64(const char* value, uint64_t hash = HASH64_OFFSET_BASIS)
+    {
+        return Hash64(value, strlen(value), hash);
+    }
+
+    static uint64_t Hash64(const std::string& value, uint64_t hash = HASH64_OFFSET_BASIS)
+    {
+        return Hash64(value.c_str(), value.size(), hash);
+    }
+}
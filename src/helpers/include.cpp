@@ -0,0 +1,86 @@
+#include "include.h"
+#include <algorithm>
+#include "../resource.h"
+
+using namespace Helpers;
+
+std::string IncludeResolver::Resolve(const std::string& include, const std::string& from)
+{
+    if(include.empty() || include[0] == '/' || include[0] == '\\') return Normalize(include);
+
+    // Resolve relative to the directory of the including file
+    auto pos = from.find_last_of("/\\");
+    if(pos == std::string::npos) return Normalize(include);
+    return Normalize(from.substr(0, pos + 1) + include);
+}
+
+std::string IncludeResolver::Normalize(const std::string& path)
+{
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while(start <= path.size())
+    {
+        size_t end = path.find_first_of("/\\", start);
+        if(end == std::string::npos) end = path.size();
+        std::string part = path.substr(start, end - start);
+        if(part == "..")
+        {
+            if(!parts.empty()) parts.pop_back();
+        }
+        else if(!part.empty() && part != ".") parts.push_back(part);
+        start = end + 1;
+    }
+
+    std::string result;
+    for(auto& part : parts)
+    {
+        if(!result.empty()) result += '/';
+        result += part;
+    }
+    return result;
+}
+
+const File* IncludeResolver::GetFile(const std::string& path)
+{
+    auto it = files.find(path);
+    if(it != files.end()) return &it->second;
+
+    File file = resource->ReadFile(path);
+    if(!file.IsValid()) return nullptr;
+    auto result = files.emplace(path, std::move(file));
+    return &result.first->second;
+}
+
+void IncludeResolver::Invalidate(const std::string& path)
+{
+    files.erase(path);
+}
+
+void IncludeResolver::AddDependency(const std::string& from, const std::string& include)
+{
+    AddFile(include);
+    auto& includes = buildDependencies[from];
+    if(std::find(includes.begin(), includes.end(), include) == includes.end()) includes.push_back(include);
+}
+
+const std::vector<std::string>& IncludeResolver::GetDependencies(const std::string& path)
+{
+    static const std::vector<std::string> empty;
+    auto it = dependencies.find(path);
+    if(it == dependencies.end()) return empty;
+    return it->second;
+}
+
+std::unordered_set<std::string> IncludeResolver::GetAllDependencies(const std::string& path)
+{
+    std::unordered_set<std::string> result;
+    std::vector<std::string> queue{path};
+    while(!queue.empty())
+    {
+        std::string current = queue.back();
+        queue.pop_back();
+        if(!result.insert(current).second) continue;
+        for(auto& include : GetDependencies(current)) queue.push_back(include);
+    }
+    return result;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "cpp-sdk/SDK.h"
+#include "file.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+class AngelScriptResource;
+namespace Helpers
+{
+    // Resolves script includes and keeps track of which file includes which
+    // Every file is only read once from the resource package, later includes use the cached content
+    class IncludeResolver
+    {
+        AngelScriptResource* resource;
+
+        // key = normalized path, value = file content
+        std::unordered_map<std::string, File> files;
+        // key = normalized path, value = hash of the content the last build used
+        std::unordered_map<std::string, uint64_t> hashes;
+        // key = normalized path, value = normalized paths of the files directly included by it
+        std::unordered_map<std::string, std::vector<std::string>> dependencies;
+        // Hashes and dependency graph of the build in progress, only taken over once the build succeeded
+        std::unordered_map<std::string, uint64_t> buildHashes;
+        std::unordered_map<std::string, std::vector<std::string>> buildDependencies;
+
+    public:
+        IncludeResolver(AngelScriptResource* resource) : resource(resource) {};
+
+        // Normalizes the include path, relative paths are resolved against the directory of the including file
+        // Paths starting with a slash are relative to the resource root
+        static std::string Resolve(const std::string& include, const std::string& from);
+        // Normalizes the path ('\' to '/', removes '.' and resolves '..')
+        static std::string Normalize(const std::string& path);
+
+        // Gets the file content, reads it from the package on first access
+        // Returns nullptr if the file does not exist
+        const File* GetFile(const std::string& path);
+        // Removes the cached content of the file, so it is read again on next access
+        void Invalidate(const std::string& path);
+        // Removes all cached file contents, the dependency graph is kept
+        void ReleaseFiles()
+        {
+            files.clear();
+        }
+
+        // Adds the file to the dependency graph of the build in progress
+        void AddFile(const std::string& path)
+        {
+            buildDependencies[path];
+        }
+        void SetFileHash(const std::string& path, uint64_t hash)
+        {
+            buildHashes[path] = hash;
+        }
+        uint64_t GetFileHash(const std::string& path)
+        {
+            auto it = hashes.find(path);
+            return it == hashes.end() ? 0 : it->second;
+        }
+        // Records that 'from' includes 'include'
+        void AddDependency(const std::string& from, const std::string& include);
+        // Starts a new dependency graph, should be called before a new build
+        // The graph of the last successful build stays in use until CommitBuild is called
+        void BeginBuild()
+        {
+            buildDependencies.clear();
+            buildHashes.clear();
+        }
+        // Replaces the dependency graph with the one of the build in progress
+        void CommitBuild()
+        {
+            dependencies = std::move(buildDependencies);
+            hashes = std::move(buildHashes);
+            BeginBuild();
+        }
+        // Gets the files directly included by the given file
+        const std::vector<std::string>& GetDependencies(const std::string& path);
+        // Gets the given file and all files it directly or indirectly includes
+        std::unordered_set<std::string> GetAllDependencies(const std::string& path);
+        // Returns whether the file is part of the last build
+        bool IsDependency(const std::string& path)
+        {
+            return dependencies.count(path) != 0;
+        }
+    };
+}
@@ -0,0 +1,65 @@
+#include "jit.h"
+#ifdef AS_JIT_BACKEND
+#include "as_jit.h"
+#endif
+
+using namespace Helpers;
+
+JITCompiler::JITCompiler()
+{
+    #ifdef AS_JIT_BACKEND
+    // Keep the FPU state of the server when calling registered functions
+    backend = new asCJITCompiler(JIT_SYSCALL_FPU_NORESET | JIT_ALLOC_SIMPLE);
+    #endif
+}
+
+JITCompiler::~JITCompiler()
+{
+    if(backend != nullptr) delete backend;
+}
+
+void JITCompiler::Finalize()
+{
+    if(!pending) return;
+    #ifdef AS_JIT_BACKEND
+    static_cast<asCJITCompiler*>(backend)->finalizePages();
+    #endif
+    pending = false;
+}
+
+bool JITCompiler::IsHot(asIScriptFunction* function)
+{
+    asUINT length = 0;
+    asDWORD* byteCode = function->GetByteCode(&length);
+    if(byteCode == nullptr) return false;
+
+    // A jump backwards is a loop, the jump offset is relative to the next instruction
+    for(asDWORD* bc = byteCode; bc < byteCode + length;)
+    {
+        asEBCInstr op = (asEBCInstr)*(asBYTE*)bc;
+        bool jump = (op >= asBC_JMP && op <= asBC_JNP) || op == asBC_JLowZ || op == asBC_JLowNZ;
+        if(jump && asBC_INTARG(bc) < 0) return true;
+        bc += asBCTypeSize[asBCInfo[op].type];
+    }
+    return false;
+}
+
+int JITCompiler::CompileFunction(asIScriptFunction* function, asJITFunction* output)
+{
+    if(backend == nullptr) return asNOT_SUPPORTED;
+    const char* moduleName = function->GetModuleName();
+    if(moduleName == nullptr) return asNOT_SUPPORTED;
+    auto it = modules.find(moduleName);
+    if(it == modules.end()) return asNOT_SUPPORTED;
+    if(!it->second && !IsHot(function)) return asNOT_SUPPORTED;
+
+    int r = backend->CompileFunction(function, output);
+    if(r >= 0) pending = true;
+    return r;
+}
+
+void JITCompiler::ReleaseJITFunction(asJITFunction func)
+{
+    // Only the backend creates jit functions
+    if(backend != nullptr) backend->ReleaseJITFunction(func);
+}
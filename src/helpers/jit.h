@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include "angelscript/include/angelscript.h"
+
+namespace Helpers
+{
+    // JIT compiler set on the engine, only compiles the functions of modules that enabled the JIT (via '#pragma jit')
+    // The native code is generated by the backend, which is only available when the module is built with AS_JIT_BACKEND
+    // By default only hot functions (the ones containing loops) are compiled, '#pragma jit all' compiles every function
+    // Functions that are not compiled (or instructions the backend doesn't support) run in the interpreter
+    class JITCompiler : public asIJITCompiler
+    {
+        asIJITCompiler* backend = nullptr;
+        // Names of the modules that should be compiled, mapped to whether all their functions are compiled
+        std::unordered_map<std::string, bool> modules;
+        // Whether functions were compiled since the last Finalize()
+        bool pending = false;
+
+    public:
+        JITCompiler();
+        ~JITCompiler();
+
+        // Whether native code can be generated at all
+        bool IsAvailable()
+        {
+            return backend != nullptr;
+        }
+        void SetEnabled(const std::string& moduleName, bool enabled, bool all = false)
+        {
+            if(enabled) modules[moduleName] = all;
+            else modules.erase(moduleName);
+        }
+        bool IsEnabled(const std::string& moduleName)
+        {
+            return modules.count(moduleName) != 0;
+        }
+
+        // Whether the function contains a loop, the interpreter overhead of the other functions is negligible
+        static bool IsHot(asIScriptFunction* function);
+
+        // Makes the code generated since the last call executable, has to be called after a module was built or loaded
+        void Finalize();
+
+        int CompileFunction(asIScriptFunction* function, asJITFunction* output) override;
+        void ReleaseJITFunction(asJITFunction func) override;
+    };
+}
@@ -1,11 +1,14 @@
 #pragma once
 #include <algorithm>
+#include <sstream>
+#include <cstdlib>
 #include "cpp-sdk/SDK.h"
 #include "Log.h"
 #include "angelscript/include/angelscript.h"
 #include "angelscript/addon/scriptbuilder/scriptbuilder.h"
 #include "../resource.h"
 #include "./docs.h"
+#include "./timings.h"
 
 // Registers a new global function (e.g. 'alt::Log')
 #define REGISTER_GLOBAL_FUNC(decl, func, desc) \
@@ -17,7 +20,7 @@
         } \
         else \
         { \
-            docs->PushDeclaration(decl, desc); \
+            DOCS_PUSH(PushDeclaration(decl, desc)); \
         } \
     }
 
@@ -31,7 +34,7 @@
         } \
         else \
         { \
-            docs->PushFuncDef(decl, desc); \
+            DOCS_PUSH(PushFuncDef(decl, desc)); \
         } \
     }
 
@@ -39,56 +42,63 @@
 #define REGISTER_VALUE_CLASS(name, type, flags, desc) \
     { \
         engine->RegisterObjectType(name, sizeof(type), flags | asGetTypeTraits<type>()); \
-        docs->PushObjectType(name, desc); \
+        DOCS_PUSH(PushObjectType(name, desc)); \
     }
 
 // Registers a new ref type class (e.g. Player)
 #define REGISTER_REF_CLASS(name, type, flags, desc) \
     { \
         engine->RegisterObjectType(name, 0, flags); \
-        docs->PushObjectType(name, desc); \
+        DOCS_PUSH(PushObjectType(name, desc)); \
+    }
+
+// Registers the reference counting behaviours of the ref type class, the class needs AddRef and Release methods
+#define REGISTER_REF_COUNTING(name, class) \
+    { \
+        engine->RegisterObjectBehaviour(name, asBEHAVE_ADDREF, "void f()", asMETHOD(class, AddRef), asCALL_THISCALL); \
+        engine->RegisterObjectBehaviour(name, asBEHAVE_RELEASE, "void f()", asMETHOD(class, Release), asCALL_THISCALL); \
     }
 
 // Registers a new class constructor
 #define REGISTER_CONSTRUCTOR(name, decl, func) \
     { \
         engine->RegisterObjectBehaviour(name, asBEHAVE_CONSTRUCT, "void f("##decl##")", asFUNCTION(func), asCALL_CDECL_OBJLAST); \
-        docs->PushObjectConstructor(name, decl); \
+        DOCS_PUSH(PushObjectConstructor(name, decl)); \
     }
 
 // Registers a new class factory (only used for classes that have a constructor in the scripting api)
 #define REGISTER_FACTORY(name, decl, func) \
     { \
         engine->RegisterObjectBehaviour(name, asBEHAVE_FACTORY, ##name##"@ f("##decl##")", asFUNCTION(func), asCALL_CDECL); \
-        docs->PushObjectConstructor(name, decl); \
+        DOCS_PUSH(PushObjectConstructor(name, decl)); \
     }
 
 // Registers a new property for the value type class
 #define REGISTER_PROPERTY(name, decl, class, property) \
     { \
         engine->RegisterObjectProperty(name, decl, asOFFSET(class, property)); \
-        docs->PushObjectProperty(name, decl); \
+        DOCS_PUSH(PushObjectProperty(name, decl)); \
     }
 
 // Registers a new method for the value type class
 #define REGISTER_METHOD(name, decl, class, method) \
     { \
         engine->RegisterObjectMethod(name, decl, asMETHOD(class, method), asCALL_THISCALL); \
-        docs->PushObjectMethod(name, decl); \
+        DOCS_PUSH(PushObjectMethod(name, decl)); \
     }
 
 // Registers a new method with a wrapper for the ref type class
 #define REGISTER_METHOD_WRAPPER(name, decl, wrapperFn) \
     { \
         engine->RegisterObjectMethod(name, decl, asFUNCTION(wrapperFn), asCALL_CDECL_OBJLAST); \
-        docs->PushObjectMethod(name, decl); \
+        DOCS_PUSH(PushObjectMethod(name, decl)); \
     }
 
 // Registers a new property getter wrapper for the class
 #define REGISTER_PROPERTY_WRAPPER_GET(name, type, prop, getFn) \
     { \
         engine->RegisterObjectMethod(name, ##type##" get_"##prop##"() const property", asFUNCTION(getFn), asCALL_CDECL_OBJLAST); \
-        docs->PushObjectProperty(name, ##type##" "##prop##); \
+        DOCS_PUSH(PushObjectProperty(name, ##type##" "##prop##)); \
     }
 
 // Registers a new property setter wrapper for the class
@@ -101,35 +111,39 @@
 #define REGISTER_GLOBAL_PROPERTY(type, prop, wrapperFn) \
     { \
         engine->RegisterGlobalFunction(##type##" get_"##prop##"() property", asFUNCTION(wrapperFn), asCALL_CDECL); \
-        docs->PushVariable(type, prop); \
+        DOCS_PUSH(PushVariable(type, prop)); \
     }
 
 // Registers a new global enum
 #define REGISTER_ENUM(name, desc) \
     { \
         engine->RegisterEnum(name); \
-        docs->PushEnumType(name, desc); \
+        DOCS_PUSH(PushEnumType(name, desc)); \
     }
 
 // Registers a new value for the specified enum
 #define REGISTER_ENUM_VALUE(enum, name, value) \
     { \
         engine->RegisterEnumValue(enum, name, (uint8_t)value); \
-        docs->PushEnumValue(enum, name, (uint8_t)value); \
+        DOCS_PUSH(PushEnumValue(enum, name, (uint8_t)value)); \
     }
 
-#define VARIADIC_ARG_INVALID "INVALID_VARIADIC_ARG"
+// Registers a generic function that takes up to argCount variable args after the fixed args
+// Registers an overload for every arg count, so only the supplied args are passed and gen->GetArgCount() is the count of the call
 #define REGISTER_VARIADIC_FUNC(type, name, defaultArgs, argCount, func, desc) \
     { \
-        std::stringstream stream; \
-        stream << ##type## << " " << ##name## << "(" << ##defaultArgs##; \
-        for(int i = 0; i < argCount; i++) \
+        const std::string defaults = defaultArgs; \
+        std::string args = defaults; \
+        for(int i = 0; i <= argCount; i++) \
         { \
-            stream << ", ?&in = \"" VARIADIC_ARG_INVALID "\""; \
+            std::string decl = std::string(type) + " " + name + "(" + args + ")"; \
+            if(engine->RegisterGlobalFunction(decl.c_str(), asFUNCTION(func), asCALL_GENERIC) < 0) \
+            { \
+                Log::Error << "Failed to register global function '" << decl << "'" << Log::Endl; \
+            } \
+            args += args.empty() ? "?&in" : ", ?&in"; \
         } \
-        stream << ")"; \
-        engine->RegisterGlobalFunction(stream.str().c_str(), asFUNCTION(func), asCALL_GENERIC); \
-        docs->PushDeclaration(##type##" "##name##"("##defaultArgs##", ...)", desc); \
+        DOCS_PUSH(PushDeclaration(std::string(type) + " " + name + "(" + (defaults.empty() ? "..." : defaults + ", ...") + ")", desc)); \
     }
 
 // Gets the currently active resource
@@ -157,11 +171,13 @@ namespace Helpers
         using CreateCallback = void(*)(asIScriptEngine*, DocsGenerator*);
 
         std::string name;
+        // Identifies the extension in the startup timings
+        std::string label;
         CreateCallback callback;
     public:
         // Creates a new module extension
         // Module extensions are used to register new classes, properties, methods etc.
-        ModuleExtension(std::string name, CreateCallback callback) : name(name), callback(callback)
+        ModuleExtension(std::string name, std::string label, CreateCallback callback) : name(name), label(label), callback(callback)
         {
             extensions.push_back(this);
         }
@@ -170,6 +186,10 @@ namespace Helpers
         {
             return name;
         }
+        std::string GetLabel()
+        {
+            return label;
+        }
 
         void Register(asIScriptEngine* engine, DocsGenerator* docs)
         {
@@ -177,13 +197,19 @@ namespace Helpers
         }
 
         // Registers all module extensions for the given module
-        static void RegisterAll(std::string name, asIScriptEngine* engine, DocsGenerator* docs)
+        static void RegisterAll(std::string name, asIScriptEngine* engine, DocsGenerator* docs, PhaseTimings* timings = nullptr)
         {
             // Sets the namespace to the module name
             engine->SetDefaultNamespace(name.c_str());
             for(auto extension : extensions)
             {
-                if(extension->GetName() == name) extension->Register(engine, docs);
+                if(extension->GetName() != name) continue;
+                if(timings == nullptr) extension->Register(engine, docs);
+                else
+                {
+                    PhaseTimings::Scope scope(*timings, "Extension " + extension->GetLabel());
+                    extension->Register(engine, docs);
+                }
             }
         }
     };
@@ -191,18 +217,74 @@ namespace Helpers
     // Handles includes
     static int IncludeHandler(const char* include, const char* from, CScriptBuilder* builder, void* data)
     {
-        // todo: add support for relative paths
         auto resource = static_cast<AngelScriptResource*>(data);
-        auto src = resource->ReadFile(alt::String(include));
-        int r = builder->AddSectionFromMemory(include, src.CStr(), src.GetSize());
+        std::string path;
+        {
+            PhaseTimings::Scope scope(resource->GetStartupTimings(), "Resolve includes");
+            // Section names are the normalized paths, so 'from' can be used to resolve relative includes
+            path = IncludeResolver::Resolve(include, from);
+            resource->GetIncludeResolver().AddDependency(from, path);
+        }
+        int r = resource->AddScriptSection(builder, path);
         CHECK_AS_RETURN("Include", r, -1);
         return 0;
     }
 
-    // Handles pragma directives
+    // Handles pragma directives, used for the per resource settings (e.g. '#pragma jit', '#pragma budget 50', '#pragma eventpolicy WeaponDamage all')
     static int PragmaHandler(const std::string& pragmaText, CScriptBuilder& builder, void* data)
     {
         auto resource = static_cast<AngelScriptResource*>(data);
+        auto& settings = resource->GetBuildSettings();
+
+        // Split the pragma into the name and the (optional) value
+        std::stringstream stream(pragmaText);
+        std::string name, value;
+        stream >> name >> value;
+
+        if(name == "jit")
+        {
+            // 'on' only compiles the hot functions, 'all' every function
+            settings.jitAll = value == "all";
+            if(value.empty() || value == "on" || value == "all") settings.jit = true;
+            else if(value == "off") settings.jit = false;
+            else
+            {
+                Log::Error << "Invalid value '" << value << "' for pragma 'jit', expected 'on', 'all' or 'off'" << Log::Endl;
+                return -1;
+            }
+        }
+        else if(name == "budget")
+        {
+            // Execution budget per script call in ms, e.g. '#pragma budget 50'
+            char* end = nullptr;
+            unsigned long budget = std::strtoul(value.c_str(), &end, 10);
+            if(value.empty() || *end != '\0')
+            {
+                Log::Error << "Invalid value '" << value << "' for pragma 'budget', expected the time in ms" << Log::Endl;
+                return -1;
+            }
+            settings.budget = (uint32_t)budget;
+        }
+        else if(name == "tickbudget")
+        {
+            // Time in ms the timers may take per tick, e.g. '#pragma tickbudget 5'
+            char* end = nullptr;
+            unsigned long budget = std::strtoul(value.c_str(), &end, 10);
+            if(value.empty() || *end != '\0')
+            {
+                Log::Error << "Invalid value '" << value << "' for pragma 'tickbudget', expected the time in ms" << Log::Endl;
+                return -1;
+            }
+            settings.tickBudget = (uint32_t)budget;
+        }
+        else if(name == "eventpolicy")
+        {
+            // How the return values of the handlers of a bool event are combined, e.g. '#pragma eventpolicy WeaponDamage all'
+            std::string policy;
+            stream >> policy;
+            if(!resource->SetEventCombinePolicy(value, policy)) return -1;
+        }
+        else Log::Warning << "Unknown pragma '" << name << "' is ignored" << Log::Endl;
         return 0;
     }
 
@@ -0,0 +1,94 @@
+#include "serializer.h"
+#include "angelscript/addon/scriptarray/scriptarray.h"
+#include "../bindings/vector3.h"
+#include "../bindings/vector2.h"
+#include <string>
+#include <cstring>
+
+using namespace Helpers;
+
+struct StringType : public CUserType
+{
+    void Store(CSerializedValue* val, void* ptr) override
+    {
+        val->SetUserData(new std::string(*static_cast<std::string*>(ptr)));
+    }
+    void Restore(CSerializedValue* val, void* ptr) override
+    {
+        *static_cast<std::string*>(ptr) = *static_cast<std::string*>(val->GetUserData());
+    }
+    void CleanupUserData(CSerializedValue* val) override
+    {
+        delete static_cast<std::string*>(val->GetUserData());
+    }
+};
+
+struct ArrayType : public CUserType
+{
+    void Store(CSerializedValue* val, void* ptr) override
+    {
+        auto arr = static_cast<CScriptArray*>(ptr);
+        for(asUINT i = 0; i < arr->GetSize(); i++)
+        {
+            val->m_children.push_back(new CSerializedValue(val, "", "", arr->At(i), arr->GetElementTypeId()));
+        }
+    }
+    void Restore(CSerializedValue* val, void* ptr) override
+    {
+        auto arr = static_cast<CScriptArray*>(ptr);
+        arr->Resize((asUINT)val->m_children.size());
+        for(asUINT i = 0; i < val->m_children.size(); i++)
+        {
+            val->m_children[i]->Restore(arr->At(i), arr->GetElementTypeId());
+        }
+    }
+};
+
+// Copies registered POD value types (e.g. the vectors)
+template<typename T>
+struct PodType : public CUserType
+{
+    void Store(CSerializedValue* val, void* ptr) override
+    {
+        val->SetUserData(new T(*static_cast<T*>(ptr)));
+    }
+    void Restore(CSerializedValue* val, void* ptr) override
+    {
+        *static_cast<T*>(ptr) = *static_cast<T*>(val->GetUserData());
+    }
+    void CleanupUserData(CSerializedValue* val) override
+    {
+        delete static_cast<T*>(val->GetUserData());
+    }
+};
+
+static const char* serializableTypes[] = { "string", "array", "Vector3f", "Vector3i", "Vector2f", "Vector2i" };
+
+void Helpers::RegisterSerializerTypes(CSerializer& serializer)
+{
+    serializer.AddUserType(new StringType(), "string");
+    serializer.AddUserType(new ArrayType(), "array");
+    serializer.AddUserType(new PodType<Vector3<float>>(), "Vector3f");
+    serializer.AddUserType(new PodType<Vector3<int>>(), "Vector3i");
+    serializer.AddUserType(new PodType<Vector2<float>>(), "Vector2f");
+    serializer.AddUserType(new PodType<Vector2<int>>(), "Vector2i");
+}
+
+bool Helpers::IsSerializableType(asIScriptEngine* engine, int typeId)
+{
+    // Primitives and handles are copied, script objects are stored member by member
+    if((typeId & asTYPEID_MASK_OBJECT) == 0 || (typeId & asTYPEID_OBJHANDLE) || (typeId & asTYPEID_SCRIPTOBJECT)) return true;
+    auto type = engine->GetTypeInfoById(typeId);
+    if(type == nullptr) return false;
+    // Funcdefs are kept like handles
+    if(type->GetFuncdefSignature() != nullptr) return true;
+    for(auto name : serializableTypes)
+    {
+        if(std::strcmp(type->GetName(), name) == 0)
+        {
+            // The elements of arrays have to be serializable too
+            return type->GetSubTypeCount() == 0 || IsSerializableType(engine, type->GetSubTypeId());
+        }
+    }
+    return false;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "angelscript/include/angelscript.h"
+#include "angelscript/addon/serializer/serializer.h"
+
+namespace Helpers
+{
+    // Registers the serializers for the add-on and value types used by scripts (string, array, vectors)
+    // The serializer takes ownership of the registered types
+    void RegisterSerializerTypes(CSerializer& serializer);
+    // Returns whether values of the type can be kept by the serializer
+    // Application types without a registered serializer are reset to their default value by a restore
+    bool IsSerializableType(asIScriptEngine* engine, int typeId);
+}
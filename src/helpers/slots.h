@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Helpers
+{
+    // Slots with generational ids, the id of a slot contains its index and its generation
+    // Freeing a slot bumps its generation, so ids of removed values stay invalid after the slot was reused
+    // A slot whose generation wraps around is retired until all other slots are used up, so a stale id can only
+    // match a new value after about as many values as there are ids were allocated
+    // Freeing doesn't move the other values, so slots can be freed while iterating
+    // The ids only use the lowest IndexBits + GenerationBits bits, the users can store flags in the remaining ones
+    template<typename T, uint32_t IndexBits, uint32_t GenerationBits>
+    class GenerationalSlots
+    {
+        static_assert(IndexBits + GenerationBits <= 32, "The id has to fit into 32 bits");
+
+        struct Slot
+        {
+            T value;
+            // Generation 0 is skipped, so an id is never 0
+            uint32_t generation = 1;
+            bool used = false;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+        // Slots whose generation wrapped around
+        std::vector<uint32_t> retiredSlots;
+        size_t count = 0;
+
+    public:
+        static const uint32_t INDEX_BITS = IndexBits;
+        static const uint32_t MAX_INDEX = (uint32_t)((1ull << IndexBits) - 1);
+        static const uint32_t MAX_GENERATION = (uint32_t)((1ull << GenerationBits) - 1);
+        // Returned instead of a slot if there is no space left or the id is invalid
+        static const uint32_t INVALID_SLOT = MAX_INDEX + 1;
+
+        // Stores the value in a free slot, returns INVALID_SLOT if all slots are used
+        uint32_t Allocate(const T& value = T())
+        {
+            uint32_t slot;
+            // All ids were used, so the retired slots can be used again
+            if(freeSlots.empty() && slots.size() > MAX_INDEX) freeSlots.swap(retiredSlots);
+            if(!freeSlots.empty())
+            {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+            else
+            {
+                if(slots.size() > MAX_INDEX) return INVALID_SLOT;
+                slot = (uint32_t)slots.size();
+                slots.emplace_back();
+            }
+
+            slots[slot].value = value;
+            slots[slot].used = true;
+            count++;
+            return slot;
+        }
+        // Resets the value of the slot, the ids of the slot become invalid
+        void Free(uint32_t slot)
+        {
+            auto& entry = slots[slot];
+            entry.value = T();
+            entry.used = false;
+            if(entry.generation == MAX_GENERATION)
+            {
+                entry.generation = 1;
+                retiredSlots.push_back(slot);
+            }
+            else
+            {
+                entry.generation++;
+                freeSlots.push_back(slot);
+            }
+            count--;
+        }
+
+        // Returns the slot of the id, INVALID_SLOT if the id is invalid or its slot was freed
+        // The bits above the generation have to be cleared by the caller
+        uint32_t Find(uint32_t id) const
+        {
+            uint32_t slot = id & MAX_INDEX;
+            if(slot >= slots.size() || !slots[slot].used || slots[slot].generation != (id >> IndexBits)) return INVALID_SLOT;
+            return slot;
+        }
+        uint32_t GetId(uint32_t slot) const
+        {
+            return (slots[slot].generation << IndexBits) | slot;
+        }
+
+        T& operator[](uint32_t slot)
+        {
+            return slots[slot].value;
+        }
+        size_t GetCount() const
+        {
+            return count;
+        }
+
+        // Removes all values, the ids handed out before can be reissued
+        void Clear()
+        {
+            slots.clear();
+            freeSlots.clear();
+            retiredSlots.clear();
+            count = 0;
+        }
+
+        // Calls the function with the slot and the value of every used slot
+        template<typename Func>
+        void ForEach(Func func)
+        {
+            for(uint32_t i = 0; i < slots.size(); i++)
+            {
+                if(slots[i].used) func(i, slots[i].value);
+            }
+        }
+    };
+}
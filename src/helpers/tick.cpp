@@ -0,0 +1,68 @@
+#include "tick.h"
+#include "Log.h"
+
+using namespace Helpers;
+
+uint32_t TickQueue::Add(asIScriptFunction* callback)
+{
+    uint32_t slot = slots.Allocate((uint32_t)entries.size());
+    if(slot == slots.INVALID_SLOT)
+    {
+        Log::Error << "Failed to add tick callback, the max amount of " << std::to_string(slots.MAX_INDEX + 1) << " callbacks is reached" << Log::Endl;
+        return 0;
+    }
+    entries.push_back({callback, slot});
+    return idFlags | slots.GetId(slot);
+}
+
+bool TickQueue::Remove(uint32_t id)
+{
+    if((id & (ID_FLAG | ONCE_FLAG)) != idFlags) return false;
+    uint32_t slot = slots.Find(id & ~(ID_FLAG | ONCE_FLAG));
+    if(slot == slots.INVALID_SLOT) return false;
+
+    auto& entry = entries[slots[slot]];
+    // Already removed while running, the entry is only waiting for the compaction
+    if(entry.callback == nullptr) return false;
+    entry.callback->Release();
+    entry.callback = nullptr;
+
+    if(running) hasRemoved = true;
+    else RemoveAt(slots[slot]);
+    return true;
+}
+
+void TickQueue::RemoveAt(uint32_t index)
+{
+    // Swap with the last entry, so the entries stay contiguous
+    uint32_t slot = entries[index].slot;
+    if(index != entries.size() - 1)
+    {
+        entries[index] = entries.back();
+        slots[entries[index].slot] = index;
+    }
+    entries.pop_back();
+    slots.Free(slot);
+}
+
+void TickQueue::Compact()
+{
+    for(uint32_t i = 0; i < entries.size();)
+    {
+        // The swapped in entry has to be checked too, so only advance if nothing was removed
+        if(entries[i].callback == nullptr) RemoveAt(i);
+        else i++;
+    }
+    hasRemoved = false;
+}
+
+void TickQueue::Clear()
+{
+    for(auto& entry : entries)
+    {
+        if(entry.callback != nullptr) entry.callback->Release();
+    }
+    entries.clear();
+    slots.Clear();
+    hasRemoved = false;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include "angelscript/include/angelscript.h"
+#include "slots.h"
+
+namespace Helpers
+{
+    // Callbacks that run on every tick (or only on the next tick), without the scheduling of timers
+    // The callbacks are stored contiguously and removed with swap-and-pop, the ids are generational
+    // slots that map to the position of the callback
+    // Callbacks can add and remove callbacks while the queue runs, added ones run starting with the next tick
+    class TickQueue
+    {
+        struct Entry
+        {
+            asIScriptFunction* callback;
+            uint32_t slot;
+        };
+        // Whether the callbacks are removed after they ran once
+        bool once;
+        // Flags set on all ids of this queue
+        uint32_t idFlags;
+        std::vector<Entry> entries;
+        // value = position in the entries
+        GenerationalSlots<uint32_t, 20, 10> slots;
+        // Removing is deferred while the queue runs, so the positions don't change
+        bool running = false;
+        bool hasRemoved = false;
+
+        void RemoveAt(uint32_t index);
+        // Removes the entries whose callback was released while running
+        void Compact();
+
+    public:
+        // Set on the ids, so they don't collide with the ids of timers
+        static const uint32_t ID_FLAG = 1u << 31;
+        // Set on the ids of the next tick queue, so they don't collide with the ids of the every tick queue
+        static const uint32_t ONCE_FLAG = 1u << 30;
+
+        TickQueue(bool once) : once(once), idFlags(ID_FLAG | (once ? ONCE_FLAG : 0)) {};
+        ~TickQueue()
+        {
+            Clear();
+        }
+
+        static bool IsTickId(uint32_t id)
+        {
+            return (id & ID_FLAG) != 0;
+        }
+        static bool IsOnceId(uint32_t id)
+        {
+            return (id & ONCE_FLAG) != 0;
+        }
+
+        // Takes over the reference to the callback, returns 0 if there is no space left
+        uint32_t Add(asIScriptFunction* callback);
+        // Releases the callback, returns false if the callback was already removed
+        bool Remove(uint32_t id);
+        void Clear();
+
+        size_t GetCount()
+        {
+            return entries.size();
+        }
+
+        // Calls the function for every callback that was added before this tick
+        template<typename Func>
+        void Run(Func call)
+        {
+            running = true;
+            size_t count = entries.size();
+            for(size_t i = 0; i < count; i++)
+            {
+                // The entries can be reallocated by the call, so don't keep a reference
+                asIScriptFunction* callback = entries[i].callback;
+                if(callback != nullptr) call(callback);
+            }
+            running = false;
+
+            if(once)
+            {
+                for(size_t i = 0; i < count; i++)
+                {
+                    if(entries[i].callback == nullptr) continue;
+                    entries[i].callback->Release();
+                    entries[i].callback = nullptr;
+                    hasRemoved = true;
+                }
+            }
+            if(hasRemoved) Compact();
+        }
+
+        // Calls the function with a reference to every callback, the callback can be replaced
+        // If it is set to nullptr, the entry is removed
+        template<typename Func>
+        void ForEach(Func func)
+        {
+            for(auto& entry : entries)
+            {
+                func(entry.callback);
+                if(entry.callback == nullptr) hasRemoved = true;
+            }
+            if(hasRemoved) Compact();
+        }
+    };
+}
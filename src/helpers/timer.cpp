@@ -1,31 +1,112 @@
 #include "timer.h"
-#include "../resource.h"
 
 using namespace Helpers;
 
-Timer::Timer(AngelScriptResource* resource, asIScriptFunction* callback, uint32_t interval, int64_t curTime, bool once) :
-    resource(resource),
+Timer::Timer(asIScriptFunction* callback, uint32_t interval, int64_t curTime, bool once) :
     callback(callback),
-    lastRun(curTime),
     interval(interval),
+    nextRun(curTime + interval),
     once(once)
 {
 }
 
-bool Timer::Update(int64_t time)
+bool Timer::Reschedule(int64_t time)
 {
-    auto elapsed = time - lastRun;
-    // If the interval has been reached, run the timer callback
-    if (elapsed >= interval)
-    {
-        auto context = resource->GetContext();
-        context->Prepare(callback);
-        context->Execute();
+    if(once) return false;
+
+    // Schedule from the deadline instead of the run time, so intervals don't drift
+    // Runs missed while the server was busy are skipped
+    nextRun += interval;
+    if(nextRun <= time) nextRun = interval == 0 ? time : nextRun + ((time - nextRun) / interval + 1) * interval;
+    return true;
+}
+
+void Timer::SetContextArgs(asIScriptContext* context)
+{
+    if(argKind == ArgKind::VALUE) context->SetArgQWord(0, arg.value);
+    else if(argKind == ArgKind::HANDLE) context->SetArgObject(0, arg.object);
+}
+
+void Timer::Release()
+{
+    if(callback != nullptr) callback->Release();
+    if(argKind == ArgKind::HANDLE && arg.object != nullptr) argType->GetEngine()->ReleaseScriptObject(arg.object, argType);
+    if(token != nullptr) token->Release();
+    callback = nullptr;
+    argKind = ArgKind::NONE;
+    token = nullptr;
+}
 
-        lastRun = time;
+void TimerToken::Cancel()
+{
+    // The last removed timer could hold the last reference
+    AddRef();
+    while(slab != nullptr && slab->Remove(firstTimer));
+    Release();
+}
 
-        return !once;
+uint32_t TimerSlab::Add(const Timer& timer)
+{
+    uint32_t slot = slots.Allocate(timer);
+    if(slot == slots.INVALID_SLOT)
+    {
+        Log::Error << "Failed to create timer, the max amount of " << std::to_string(slots.MAX_INDEX + 1) << " timers is reached" << Log::Endl;
+        return 0;
     }
+    uint32_t id = slots.GetId(slot);
 
+    auto& added = slots[slot];
+    auto token = added.token;
+    // Tokens can't be shared between resources, the timer is kept without the token of another slab
+    if(token != nullptr && token->slab != nullptr && token->slab != this)
+    {
+        token->Release();
+        added.token = nullptr;
+    }
+    else if(token != nullptr)
+    {
+        added.prevTimer = 0;
+        added.nextTimer = token->firstTimer;
+        if(token->firstTimer != 0) Get(token->firstTimer)->prevTimer = id;
+        token->firstTimer = id;
+        token->slab = this;
+    }
+    return id;
+}
+
+void TimerSlab::Unlink(Timer& timer)
+{
+    auto token = timer.token;
+    if(token == nullptr) return;
+
+    if(timer.prevTimer != 0) Get(timer.prevTimer)->nextTimer = timer.nextTimer;
+    else token->firstTimer = timer.nextTimer;
+    if(timer.nextTimer != 0) Get(timer.nextTimer)->prevTimer = timer.prevTimer;
+    if(token->firstTimer == 0) token->slab = nullptr;
+}
+
+Timer* TimerSlab::Get(uint32_t id)
+{
+    uint32_t slot = slots.Find(id);
+    if(slot == slots.INVALID_SLOT) return nullptr;
+    return &slots[slot];
+}
+
+bool TimerSlab::Remove(uint32_t id)
+{
+    uint32_t slot = slots.Find(id);
+    if(slot == slots.INVALID_SLOT) return false;
+    Unlink(slots[slot]);
+    slots[slot].Release();
+    slots.Free(slot);
     return true;
 }
+
+void TimerSlab::Clear()
+{
+    slots.ForEach([this](uint32_t slot, Timer& timer) {
+        Unlink(timer);
+        timer.Release();
+    });
+    slots.Clear();
+}
@@ -3,22 +3,176 @@
 #include "cpp-sdk/SDK.h"
 #include "Log.h"
 #include "angelscript/include/angelscript.h"
+#include "slots.h"
 #include <chrono>
+#include <vector>
 
-class AngelScriptResource;
 namespace Helpers
 {
+    class TimerSlab;
+
+    // Cancels all timers created with it at once, the token can be used for new timers after cancelling
+    // The timers of a token are linked through their ids, so cancelling removes them right away
+    class TimerToken
+    {
+        friend class TimerSlab;
+
+        int refCount = 1;
+        // Slab of the linked timers, only set while the token has timers
+        TimerSlab* slab = nullptr;
+        uint32_t firstTimer = 0;
+
+    public:
+        void AddRef()
+        {
+            refCount++;
+        }
+        void Release()
+        {
+            if(--refCount == 0) delete this;
+        }
+
+        // Removes all timers of the token, their callbacks and arguments are released right away
+        void Cancel();
+    };
+
     class Timer
     {
-        AngelScriptResource* resource;
-        asIScriptFunction* callback;
-        uint32_t interval;
-        int64_t lastRun;
-        bool once;
+    public:
+        // High priority timers always run when due, normal ones can be deferred when the tick budget is used up
+        enum class Priority : uint8_t
+        {
+            NORMAL,
+            HIGH
+        };
+
+    private:
+        enum class ArgKind : uint8_t
+        {
+            NONE,
+            VALUE,
+            HANDLE
+        };
+
+        asIScriptFunction* callback = nullptr;
+        uint32_t interval = 0;
+        // Deadline of the next run in ms
+        int64_t nextRun = 0;
+        bool once = true;
+        Priority priority = Priority::NORMAL;
+
+        // Argument bound to the callback, stored inline so scripts don't need a closure per timer
+        ArgKind argKind = ArgKind::NONE;
+        union
+        {
+            int64_t value;
+            void* object;
+        } arg = {0};
+        asITypeInfo* argType = nullptr;
+
+        TimerToken* token = nullptr;
+        // Neighbours in the timer list of the token, 0 marks the ends
+        uint32_t prevTimer = 0;
+        uint32_t nextTimer = 0;
+
+        friend class TimerSlab;
+
+    public:
+        Timer() = default;
+        Timer(asIScriptFunction* callback, uint32_t interval, int64_t curTime, bool once);
+
+        int64_t GetNextRun()
+        {
+            return nextRun;
+        }
+        bool IsDue(int64_t time)
+        {
+            return nextRun <= time;
+        }
+        // How long the timer is already waiting for its run in ms
+        int64_t GetDelay(int64_t time)
+        {
+            return time - nextRun;
+        }
+        // Schedules the next run after the timer ran, returns whether the timer should be kept
+        bool Reschedule(int64_t time);
+
+        asIScriptFunction* GetCallback()
+        {
+            return callback;
+        }
+        void SetCallback(asIScriptFunction* func)
+        {
+            callback = func;
+        }
+        Priority GetPriority()
+        {
+            return priority;
+        }
+        void SetPriority(Priority value)
+        {
+            priority = value;
+        }
+
+        void SetArg(int64_t value)
+        {
+            argKind = ArgKind::VALUE;
+            arg.value = value;
+        }
+        // Takes over the reference to the object
+        void SetArgHandle(void* object, asITypeInfo* type)
+        {
+            argKind = ArgKind::HANDLE;
+            arg.object = object;
+            argType = type;
+        }
+        // Takes over the reference to the token, the timer is linked to the token when it is added to a slab
+        void SetToken(TimerToken* value)
+        {
+            token = value;
+        }
+
+        // Passes the bound argument to the prepared context
+        void SetContextArgs(asIScriptContext* context);
+        // Releases the callback, the bound argument and the token
+        void Release();
+    };
+
+    // Stores the timers of a resource in one contiguous block, removed slots are reused
+    // The ids are generational, so ids of removed timers stay invalid after the slot was reused
+    // The highest bit is never set, it marks the ids of tick callbacks
+    class TimerSlab
+    {
+        GenerationalSlots<Timer, 20, 11> slots;
+
+        void Unlink(Timer& timer);
 
     public:
-        Timer(AngelScriptResource* resource, asIScriptFunction* callback, uint32_t interval, int64_t curTime, bool once);
+        ~TimerSlab()
+        {
+            Clear();
+        }
+
+        // Returns the id of the timer, 0 if there is no space left
+        uint32_t Add(const Timer& timer);
+        // Returns nullptr if the timer was removed
+        Timer* Get(uint32_t id);
+        // Releases the callback of the timer, returns false if the timer was already removed
+        bool Remove(uint32_t id);
+        // Removes all timers
+        void Clear();
+
+        size_t GetCount()
+        {
+            return slots.GetCount();
+        }
 
-        bool Update(int64_t time);
+        template<typename Func>
+        void ForEach(Func func)
+        {
+            slots.ForEach([&](uint32_t slot, Timer& timer) {
+                func(slots.GetId(slot), timer);
+            });
+        }
     };
 }
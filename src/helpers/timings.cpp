@@ -0,0 +1,74 @@
+#include "timings.h"
+#include "Log.h"
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+
+using namespace Helpers;
+
+static std::string FormatTime(int64_t microseconds)
+{
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(2) << (microseconds / 1000.0) << "ms";
+    return stream.str();
+}
+
+void PhaseTimings::Add(const std::string& phase, int64_t microseconds)
+{
+    for(auto& entry : phases)
+    {
+        if(entry.first != phase) continue;
+        entry.second += microseconds;
+        return;
+    }
+    phases.push_back({phase, microseconds});
+}
+
+int64_t PhaseTimings::Get(const std::string& phase)
+{
+    for(auto& entry : phases)
+    {
+        if(entry.first == phase) return entry.second;
+    }
+    return 0;
+}
+
+void PhaseTimings::Print()
+{
+    Log::Info << "Startup timings of " << name << " (total " << FormatTime(GetElapsed()) << "):" << Log::Endl;
+    for(auto& entry : phases)
+    {
+        std::stringstream line;
+        line << "    " << std::left << std::setw(32) << entry.first << std::right << std::setw(12) << FormatTime(entry.second);
+        Log::Info << line.str() << Log::Endl;
+    }
+}
+
+bool PhaseTimings::WriteJson(const std::string& path)
+{
+    std::error_code err;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), err);
+
+    std::ofstream file(path, std::ios::trunc);
+    if(!file.is_open())
+    {
+        Log::Warning << "Failed to write startup timings to '" << path << "'" << Log::Endl;
+        return false;
+    }
+
+    // Phase names are fixed identifiers without characters that need escaping
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    file << "{\n";
+    file << "  \"name\": \"" << name << "\",\n";
+    file << "  \"timestamp\": " << now << ",\n";
+    file << "  \"totalUs\": " << GetElapsed() << ",\n";
+    file << "  \"phases\": [";
+    for(size_t i = 0; i < phases.size(); i++)
+    {
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    { \"name\": \"" << phases[i].first << "\", \"us\": " << phases[i].second << " }";
+    }
+    file << "\n  ]\n";
+    file << "}\n";
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Helpers
+{
+    // Records how long the phases of a process (e.g. the resource startup) took
+    // Adding the same phase multiple times accumulates the durations
+    class PhaseTimings
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::string name;
+        // first = phase name, second = duration in microseconds
+        std::vector<std::pair<std::string, int64_t>> phases;
+        Clock::time_point start = Clock::now();
+
+    public:
+        // Measures the time until it goes out of scope
+        class Scope
+        {
+            PhaseTimings& timings;
+            std::string phase;
+            Clock::time_point start;
+
+        public:
+            Scope(PhaseTimings& timings, std::string phase) : timings(timings), phase(phase), start(Clock::now()) {};
+            ~Scope()
+            {
+                timings.Add(phase, std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+            }
+        };
+
+        PhaseTimings(std::string name) : name(name) {};
+
+        void Add(const std::string& phase, int64_t microseconds);
+        // Gets the accumulated duration of the phase in microseconds
+        int64_t Get(const std::string& phase);
+        // Gets the time since the timings were created or reset in microseconds
+        int64_t GetElapsed()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        }
+        void Reset()
+        {
+            phases.clear();
+            start = Clock::now();
+        }
+
+        // Logs a table of all phases
+        void Print();
+        // Writes the phases as JSON to the file
+        bool WriteJson(const std::string& path);
+    };
+}
@@ -0,0 +1,206 @@
+#include "typedargs.h"
+#include "../runtime.h"
+
+using namespace Helpers;
+
+TypedEventArgs::Kind TypedEventArgs::GetParamKind(AngelScriptRuntime* runtime, int typeId, asDWORD flags)
+{
+    // Out and inout references, the values can't be written back to the event
+    if(flags & asTM_OUTREF) return Kind::INVALID;
+
+    if(typeId & asTYPEID_OBJHANDLE)
+    {
+        int objectTypeId = typeId & ~asTYPEID_OBJHANDLE;
+        if(flags & asTM_INREF) return Kind::INVALID;
+        if(objectTypeId == runtime->GetBaseObjectTypeId()) return Kind::BASE_OBJECT;
+        if(objectTypeId == runtime->GetWorldObjectTypeId()) return Kind::WORLD_OBJECT;
+        if(objectTypeId == runtime->GetEntityTypeId()) return Kind::ENTITY;
+        if(objectTypeId == runtime->GetPlayerTypeId()) return Kind::PLAYER;
+        if(objectTypeId == runtime->GetVehicleTypeId()) return Kind::VEHICLE;
+        return Kind::INVALID;
+    }
+
+    static int vector3TypeId = runtime->GetEngine()->GetTypeIdByDecl("Vector3f");
+    static int vector2TypeId = runtime->GetEngine()->GetTypeIdByDecl("Vector2f");
+    // Objects can be passed by value or as const reference
+    if(typeId == runtime->GetStringTypeId()) return Kind::STRING;
+    if(typeId == vector3TypeId) return Kind::VECTOR3;
+    if(typeId == vector2TypeId) return Kind::VECTOR2;
+
+    // Primitives only by value
+    if(flags & asTM_INREF) return Kind::INVALID;
+    switch(typeId)
+    {
+        case asTYPEID_BOOL: return Kind::BOOL;
+        case asTYPEID_INT8: case asTYPEID_UINT8: return Kind::INT8;
+        case asTYPEID_INT16: case asTYPEID_UINT16: return Kind::INT16;
+        case asTYPEID_INT32: case asTYPEID_UINT32: return Kind::INT32;
+        case asTYPEID_INT64: case asTYPEID_UINT64: return Kind::INT64;
+        case asTYPEID_FLOAT: return Kind::FLOAT;
+        case asTYPEID_DOUBLE: return Kind::DOUBLE;
+    }
+    return Kind::INVALID;
+}
+
+bool TypedEventArgs::ValidateHandler(AngelScriptRuntime* runtime, asIScriptFunction* handler, asUINT firstArg, std::string& error)
+{
+    if(handler->GetReturnTypeId() != asTYPEID_VOID)
+    {
+        error = "The handler has to return void";
+        return false;
+    }
+    if(handler->GetParamCount() < firstArg || handler->GetParamCount() - firstArg > MAX_ARGS)
+    {
+        error = "The handler can have at most " + std::to_string(MAX_ARGS) + " args";
+        return false;
+    }
+    for(asUINT i = firstArg; i < handler->GetParamCount(); i++)
+    {
+        int typeId;
+        asDWORD flags;
+        handler->GetParam(i, &typeId, &flags);
+        if(GetParamKind(runtime, typeId, flags) == Kind::INVALID)
+        {
+            error = "The type of arg " + std::to_string(i - firstArg + 1) + " (" + runtime->GetEngine()->GetTypeDeclaration(typeId, true) +
+                ") is not supported, use bool, numbers, string, Vector3f, Vector2f or base object handles";
+            return false;
+        }
+    }
+    return true;
+}
+
+TypedEventArgs::TypedEventArgs(AngelScriptRuntime* runtime, const alt::MValueArgs& args) : runtime(runtime)
+{
+    tooManyArgs = args.GetSize() > MAX_ARGS;
+    count = tooManyArgs ? 0 : (asUINT)args.GetSize();
+    for(asUINT i = 0; i < count; i++)
+    {
+        auto arg = args[i];
+        auto& value = values[i];
+        value.type = arg->GetType();
+        switch(value.type)
+        {
+            case alt::IMValue::Type::BOOL: value.boolValue = arg.As<alt::IMValueBool>()->Value(); break;
+            case alt::IMValue::Type::INT: value.intValue = arg.As<alt::IMValueInt>()->Value(); break;
+            case alt::IMValue::Type::UINT: value.intValue = (int64_t)arg.As<alt::IMValueUInt>()->Value(); break;
+            case alt::IMValue::Type::DOUBLE: value.doubleValue = arg.As<alt::IMValueDouble>()->Value(); break;
+            case alt::IMValue::Type::STRING: value.string = arg.As<alt::IMValueString>()->Value().ToString(); break;
+            case alt::IMValue::Type::BASE_OBJECT: value.object = arg.As<alt::IMValueBaseObject>()->Value().Get(); break;
+            case alt::IMValue::Type::VECTOR3:
+            {
+                auto vector = arg.As<alt::IMValueVector3>()->Value();
+                value.vector3 = Vector3<float>(vector[0], vector[1], vector[2]);
+                break;
+            }
+            case alt::IMValue::Type::VECTOR2:
+            {
+                auto vector = arg.As<alt::IMValueVector2>()->Value();
+                value.vector2 = Vector2<float>(vector[0], vector[1]);
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+bool TypedEventArgs::SetArgs(asIScriptContext* context, asIScriptFunction* handler, asUINT firstArg, std::string& error)
+{
+    if(tooManyArgs || handler->GetParamCount() - firstArg != count)
+    {
+        error = "The handler expects " + std::to_string(handler->GetParamCount() - firstArg) + " args, but the event has " +
+            (tooManyArgs ? "more than " + std::to_string(MAX_ARGS) : std::to_string(count));
+        return false;
+    }
+    for(asUINT i = 0; i < count; i++)
+    {
+        int typeId;
+        asDWORD flags;
+        handler->GetParam(firstArg + i, &typeId, &flags);
+        if(!SetArg(context, firstArg + i, GetParamKind(runtime, typeId, flags), values[i]))
+        {
+            error = "Arg " + std::to_string(i + 1) + " can't be passed as " + runtime->GetEngine()->GetTypeDeclaration(typeId, true);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TypedEventArgs::SetArg(asIScriptContext* context, asUINT index, Kind kind, const Value& value)
+{
+    using Type = alt::IMValue::Type;
+    bool isInt = value.type == Type::INT || value.type == Type::UINT;
+    switch(kind)
+    {
+        case Kind::BOOL:
+        {
+            if(value.type != Type::BOOL) return false;
+            return context->SetArgByte(index, value.boolValue) >= 0;
+        }
+        case Kind::INT8:
+        {
+            if(!isInt) return false;
+            return context->SetArgByte(index, (asBYTE)value.intValue) >= 0;
+        }
+        case Kind::INT16:
+        {
+            if(!isInt) return false;
+            return context->SetArgWord(index, (asWORD)value.intValue) >= 0;
+        }
+        case Kind::INT32:
+        {
+            if(!isInt) return false;
+            return context->SetArgDWord(index, (asDWORD)value.intValue) >= 0;
+        }
+        case Kind::INT64:
+        {
+            if(!isInt) return false;
+            return context->SetArgQWord(index, (asQWORD)value.intValue) >= 0;
+        }
+        // Numbers sent from other runtimes may arrive as ints, so they are converted too
+        case Kind::FLOAT:
+        {
+            if(value.type == Type::DOUBLE) return context->SetArgFloat(index, (float)value.doubleValue) >= 0;
+            if(isInt) return context->SetArgFloat(index, (float)value.intValue) >= 0;
+            return false;
+        }
+        case Kind::DOUBLE:
+        {
+            if(value.type == Type::DOUBLE) return context->SetArgDouble(index, value.doubleValue) >= 0;
+            if(isInt) return context->SetArgDouble(index, (double)value.intValue) >= 0;
+            return false;
+        }
+        case Kind::STRING:
+        {
+            if(value.type != Type::STRING) return false;
+            return context->SetArgObject(index, (void*)&value.string) >= 0;
+        }
+        case Kind::VECTOR3:
+        {
+            if(value.type != Type::VECTOR3) return false;
+            return context->SetArgObject(index, (void*)&value.vector3) >= 0;
+        }
+        case Kind::VECTOR2:
+        {
+            if(value.type != Type::VECTOR2) return false;
+            return context->SetArgObject(index, (void*)&value.vector2) >= 0;
+        }
+        default: break;
+    }
+
+    // Base object handles, nil is passed as null
+    if(value.type == Type::NIL) return context->SetArgObject(index, nullptr) >= 0;
+    if(value.type != Type::BASE_OBJECT) return false;
+    void* object = nullptr;
+    switch(kind)
+    {
+        case Kind::BASE_OBJECT: object = value.object; break;
+        case Kind::WORLD_OBJECT: object = dynamic_cast<alt::IWorldObject*>(value.object); break;
+        case Kind::ENTITY: object = dynamic_cast<alt::IEntity*>(value.object); break;
+        case Kind::PLAYER: object = dynamic_cast<alt::IPlayer*>(value.object); break;
+        case Kind::VEHICLE: object = dynamic_cast<alt::IVehicle*>(value.object); break;
+        default: return false;
+    }
+    // The object is of another type than the handler expects
+    if(object == nullptr && value.object != nullptr) return false;
+    return context->SetArgObject(index, object) >= 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include "cpp-sdk/SDK.h"
+#include "angelscript/include/angelscript.h"
+#include "../bindings/vector3.h"
+#include "../bindings/vector2.h"
+
+class AngelScriptRuntime;
+namespace Helpers
+{
+    // Args of a custom event for handlers that declare the types of the args in their signature
+    // The MValues are converted once per event and set directly as the args of the handlers, without boxing them in anys
+    class TypedEventArgs
+    {
+    public:
+        static const asUINT MAX_ARGS = 16;
+
+        enum class Kind
+        {
+            INVALID,
+            BOOL,
+            INT8,
+            INT16,
+            INT32,
+            INT64,
+            FLOAT,
+            DOUBLE,
+            STRING,
+            VECTOR3,
+            VECTOR2,
+            BASE_OBJECT,
+            WORLD_OBJECT,
+            ENTITY,
+            PLAYER,
+            VEHICLE
+        };
+
+        // Gets the kind of a handler param, INVALID if the param can't be set from an MValue
+        static Kind GetParamKind(AngelScriptRuntime* runtime, int typeId, asDWORD flags);
+        // Checks whether the handler can be used for typed custom events, the params before the first arg are set by the caller
+        // Returns false and sets the error if it can't
+        static bool ValidateHandler(AngelScriptRuntime* runtime, asIScriptFunction* handler, asUINT firstArg, std::string& error);
+
+    private:
+        struct Value
+        {
+            alt::IMValue::Type type = alt::IMValue::Type::NIL;
+            union
+            {
+                bool boolValue;
+                int64_t intValue;
+                double doubleValue;
+                alt::IBaseObject* object;
+            };
+            std::string string;
+            Vector3<float> vector3{0, 0, 0};
+            Vector2<float> vector2{0, 0};
+        };
+
+        AngelScriptRuntime* runtime;
+        // Kept alive until all handlers ran, references to the values are passed to the handlers
+        Value values[MAX_ARGS];
+        asUINT count = 0;
+        bool tooManyArgs = false;
+
+        bool SetArg(asIScriptContext* context, asUINT index, Kind kind, const Value& value);
+
+    public:
+        TypedEventArgs(AngelScriptRuntime* runtime, const alt::MValueArgs& args);
+
+        // Sets the args on the prepared context, starting at the param of the first arg
+        // Returns false and sets the error if the args don't match the params of the handler
+        bool SetArgs(asIScriptContext* context, asIScriptFunction* handler, asUINT firstArg, std::string& error);
+    };
+}
@@ -0,0 +1,78 @@
+#include "watchdog.h"
+#include "clock.h"
+#include <chrono>
+#include <sstream>
+
+using namespace Helpers;
+
+void Watchdog::Begin(asIScriptContext* context, uint32_t budget)
+{
+    // The thread is only needed once a resource uses a budget
+    if(!running)
+    {
+        running = true;
+        thread = std::thread(&Watchdog::Run, this);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    invocations.push_back({context, GetTime() + budget, false});
+}
+
+bool Watchdog::End(bool suspended)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Invocation invocation = invocations.back();
+    invocations.pop_back();
+    if(!invocation.exceeded) return false;
+    if(suspended) return true;
+
+    // The call returned before the suspend took effect, nested calls of a resource share its budget,
+    // so the outer call has exceeded it as well
+    if(!invocations.empty() && invocations.back().context == invocation.context) invocations.back().exceeded = true;
+    return false;
+}
+
+void Watchdog::Stop()
+{
+    running = false;
+    if(thread.joinable()) thread.join();
+}
+
+void Watchdog::Run()
+{
+    while(running)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(CHECK_INTERVAL));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if(invocations.empty()) continue;
+        int64_t time = GetTime();
+        for(auto& invocation : invocations)
+        {
+            if(invocation.deadline > time) continue;
+            // Only the innermost call is running, once it returned the outer call gets suspended on the next check
+            auto& current = invocations.back();
+            if(!current.exceeded)
+            {
+                current.exceeded = true;
+                current.context->Suspend();
+            }
+            break;
+        }
+    }
+}
+
+std::string Watchdog::GetCallstack(asIScriptContext* context)
+{
+    std::stringstream stream;
+    for(asUINT i = 0; i < context->GetCallstackSize(); i++)
+    {
+        asIScriptFunction* func = context->GetFunction(i);
+        if(func == nullptr) continue;
+        const char* section = nullptr;
+        int column = 0;
+        int line = context->GetLineNumber(i, &column, &section);
+        stream << "    " << func->GetDeclaration(true, true) << " (" << (section != nullptr ? section : "?") << ":" << line << ")\n";
+    }
+    return stream.str();
+}
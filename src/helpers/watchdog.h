@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "angelscript/include/angelscript.h"
+
+namespace Helpers
+{
+    // Interrupts script calls that run longer than their budget (e.g. an endless loop in an event handler)
+    // The calls are only tracked on the main thread, a separate thread checks the deadlines every CHECK_INTERVAL ms
+    // and suspends the context, so the callstack is still available when the call returns
+    class Watchdog
+    {
+        struct Invocation
+        {
+            asIScriptContext* context;
+            int64_t deadline;
+            bool exceeded;
+        };
+
+        std::mutex mutex;
+        std::thread thread;
+        std::atomic<bool> running{false};
+        // Nested script calls are pushed on top
+        std::vector<Invocation> invocations;
+
+        void Run();
+
+    public:
+        static const int CHECK_INTERVAL = 5;
+
+        ~Watchdog()
+        {
+            Stop();
+        }
+
+        // Starts watching a script call with the given budget in ms
+        void Begin(asIScriptContext* context, uint32_t budget);
+        // Stops watching the last started script call, returns whether it was suspended because it exceeded its budget
+        // A suspend that lands after the call already returned stays pending on the context and would suspend the
+        // outer call of a nested context instead, so the outer call is marked as exceeded too
+        bool End(bool suspended);
+        void Stop();
+
+        // Gets the current callstack of the context, one function per line
+        static std::string GetCallstack(asIScriptContext* context);
+    };
+}
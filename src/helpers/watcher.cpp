@@ -0,0 +1,216 @@
+#include "watcher.h"
+#include "hash.h"
+#include "clock.h"
+#include "Log.h"
+#include "../resource.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+using namespace Helpers;
+
+void FileWatcher::Watch(AngelScriptResource* resource, const std::unordered_map<std::string, uint64_t>& paths)
+{
+#ifdef __linux__
+    Start();
+    if(fd < 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto it = files.begin(); it != files.end();)
+    {
+        if(it->second.resource == resource) it = files.erase(it);
+        else it++;
+    }
+    for(auto& kv : paths) files.insert({kv.first, WatchedFile{resource, kv.second}});
+    UpdateDirectories();
+#endif
+}
+
+void FileWatcher::Unwatch(AngelScriptResource* resource)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto it = files.begin(); it != files.end();)
+    {
+        if(it->second.resource == resource) it = files.erase(it);
+        else it++;
+    }
+    pending.erase(resource);
+    UpdateDirectories();
+}
+
+void FileWatcher::UpdateDirectories()
+{
+#ifdef __linux__
+    if(fd < 0) return;
+
+    // Watch the directories instead of the files, as most editors save by replacing the file
+    std::unordered_set<std::string> needed;
+    for(auto& kv : files) needed.insert(std::filesystem::path(kv.first).parent_path().string());
+
+    for(auto it = directories.begin(); it != directories.end();)
+    {
+        if(needed.erase(it->second) != 0)
+        {
+            it++;
+            continue;
+        }
+        inotify_rm_watch(fd, it->first);
+        it = directories.erase(it);
+    }
+    for(auto& dir : needed)
+    {
+        int wd = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if(wd < 0)
+        {
+            Log::Warning << "Failed to watch directory '" << dir << "'" << Log::Endl;
+            continue;
+        }
+        directories[wd] = dir;
+    }
+#endif
+}
+
+void FileWatcher::Start()
+{
+#ifdef __linux__
+    if(running) return;
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(fd < 0)
+    {
+        Log::Error << "Failed to initialize inotify, file watching is disabled" << Log::Endl;
+        return;
+    }
+    running = true;
+    thread = std::thread(&FileWatcher::Run, this);
+#endif
+}
+
+void FileWatcher::Stop()
+{
+#ifdef __linux__
+    if(!running) return;
+    running = false;
+    if(thread.joinable()) thread.join();
+    for(auto& kv : directories) inotify_rm_watch(fd, kv.first);
+    directories.clear();
+    close(fd);
+    fd = -1;
+#endif
+}
+
+void FileWatcher::Run()
+{
+#ifdef __linux__
+    while(running)
+    {
+        pollfd pfd{fd, POLLIN, 0};
+        // Wake up regularly to check the debounced changes and whether the watcher was stopped
+        int r = poll(&pfd, 1, 50);
+        if(r > 0 && (pfd.revents & POLLIN)) ReadEvents();
+        ProcessPending();
+    }
+#endif
+}
+
+void FileWatcher::ReadEvents()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    ssize_t len;
+    while((len = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int64_t now = GetTime();
+        for(char* ptr = buffer; ptr < buffer + len;)
+        {
+            auto event = reinterpret_cast<inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+            // The watch was removed, either by us or because the directory was deleted
+            if(event->mask & IN_IGNORED)
+            {
+                directories.erase(event->wd);
+                continue;
+            }
+            if(event->len == 0) continue;
+
+            auto dir = directories.find(event->wd);
+            if(dir == directories.end()) continue;
+            std::string path = dir->second + "/" + event->name;
+
+            auto range = files.equal_range(path);
+            for(auto it = range.first; it != range.second; it++)
+            {
+                auto& reload = pending[it->second.resource];
+                reload.lastChange = now;
+                reload.files.insert(path);
+            }
+        }
+    }
+#endif
+}
+
+void FileWatcher::ProcessPending()
+{
+    // Take the settled changes out under the lock, reading and hashing the files happens without it
+    // so the inotify events and the Watch/Unwatch calls of the server are not blocked by the file I/O
+    std::vector<std::pair<AngelScriptResource*, std::unordered_set<std::string>>> settled;
+    {
+        int64_t now = GetTime();
+        std::lock_guard<std::mutex> lock(mutex);
+        for(auto it = pending.begin(); it != pending.end();)
+        {
+            if(now - it->second.lastChange < DEBOUNCE_TIME)
+            {
+                it++;
+                continue;
+            }
+            settled.emplace_back(it->first, std::move(it->second.files));
+            it = pending.erase(it);
+        }
+    }
+    if(settled.empty()) return;
+
+    std::unordered_map<std::string, uint64_t> hashes;
+    for(auto& reload : settled)
+    {
+        for(auto& path : reload.second)
+        {
+            if(hashes.count(path) != 0) continue;
+            std::error_code err;
+            uint64_t hash = 0;
+            if(std::filesystem::exists(path, err))
+            {
+                std::string content;
+                std::ifstream stream(path, std::ios::binary);
+                content.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+                hash = Hash64(content.data(), content.size());
+            }
+            hashes[path] = hash;
+        }
+    }
+
+    // Only reload if the content really changed, saving without changes also triggers events
+    // The resource can have been unwatched in between, then its files are gone and it is not touched
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto& reload : settled)
+    {
+        bool changed = false;
+        for(auto& path : reload.second)
+        {
+            uint64_t hash = hashes[path];
+            auto range = files.equal_range(path);
+            for(auto file = range.first; file != range.second; file++)
+            {
+                if(file->second.resource != reload.first || file->second.hash == hash) continue;
+                file->second.hash = hash;
+                changed = true;
+            }
+        }
+        if(changed) reload.first->RequestHotReload();
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+class AngelScriptResource;
+namespace Helpers
+{
+    // Watches the script files of resources and schedules a hot reload of a resource when one of its files changes
+    // Uses inotify, so watching is only supported on Linux
+    class FileWatcher
+    {
+        struct WatchedFile
+        {
+            AngelScriptResource* resource;
+            // Hash of the file content the current module was built from
+            uint64_t hash;
+        };
+        struct PendingReload
+        {
+            int64_t lastChange;
+            std::unordered_set<std::string> files;
+        };
+
+        std::mutex mutex;
+        std::thread thread;
+        std::atomic<bool> running{false};
+        int fd = -1;
+
+        // key = watch descriptor, value = watched directory
+        std::unordered_map<int, std::string> directories;
+        // key = absolute file path
+        std::unordered_multimap<std::string, WatchedFile> files;
+        // Changes are collected until no new change happened for DEBOUNCE_TIME ms
+        std::unordered_map<AngelScriptResource*, PendingReload> pending;
+
+        void Start();
+        // Watches the directories of the watched files and removes the watches of directories not needed anymore
+        // Has to be called with the mutex locked
+        void UpdateDirectories();
+        void Run();
+        void ReadEvents();
+        void ProcessPending();
+
+    public:
+        static const int DEBOUNCE_TIME = 250;
+
+        ~FileWatcher()
+        {
+            Stop();
+        }
+
+        // Watches the given files (key = absolute path, value = content hash) of the resource
+        // Replaces the files watched for the resource before
+        void Watch(AngelScriptResource* resource, const std::unordered_map<std::string, uint64_t>& paths);
+        // Stops watching all files of the resource
+        void Unwatch(AngelScriptResource* resource);
+        void Stop();
+    };
+}
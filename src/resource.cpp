@@ -4,31 +4,28 @@
 #include "helpers/events.h"
 #include "angelscript/addon/scriptany/scriptany.h"
 #include "helpers/convert.h"
+#include "helpers/typedargs.h"
+#include "helpers/hash.h"
+#include "helpers/bytecode.h"
+#include "helpers/serializer.h"
+#include <filesystem>
+#include <algorithm>
 
 bool AngelScriptResource::Start()
 {
-    // Load file
-    auto src = ReadFile(resource->GetMain());
+    std::string name = resource->GetName().ToString();
+    startupTimings = Helpers::PhaseTimings("resource '" + name + "'");
 
     // Compile file
     CScriptBuilder builder;
+    module = BuildModule(builder, name);
+    if(module == nullptr) return false;
 
-    builder.SetIncludeCallback(Helpers::IncludeHandler, this);
-    builder.SetPragmaCallback(Helpers::PragmaHandler, this);
-
-    int r = builder.StartNewModule(runtime->GetEngine(), resource->GetName().CStr());
-    CHECK_AS_RETURN("Builder start", r, false);
-    
-    r = builder.AddSectionFromMemory(resource->GetMain().CStr(), src.CStr(), src.GetSize());
-    CHECK_AS_RETURN("Adding section", r, false);
-
-    r = builder.BuildModule();
-    CHECK_AS_RETURN("Compilation", r, false);
+    CommitBuild();
+    WatchFiles();
 
     // Start script
-    module = builder.GetModule();
-    context = runtime->GetEngine()->CreateContext();
-    context->SetUserData(this);
+    contextPool.Init(runtime->GetEngine(), this);
 
     // Get metadata (returns start function)
     asIScriptFunction* func = RegisterMetadata(builder);
@@ -40,14 +37,17 @@ bool AngelScriptResource::Start()
     {
         Log::Error << "The main entrypoint ('void Start()') was not found" << Log::Endl;
         module->Discard();
-        context->Release();
         return false;
     }
-    r = context->Prepare(func);
-    CHECK_AS_RETURN("Context prepare", r, false);
+    auto context = contextPool.Prepare(func);
+    if(context == nullptr) return false;
 
     // Execute script
-    r = context->Execute();
+    int r;
+    {
+        Helpers::PhaseTimings::Scope scope(startupTimings, "Execute Start()");
+        r = Execute(context);
+    }
     switch(r)
     {
         case asEXECUTION_EXCEPTION:
@@ -57,65 +57,355 @@ bool AngelScriptResource::Start()
             break;
         }
     }
+    contextPool.Return(context);
+
+    startupTimings.Print();
+    startupTimings.WriteJson(alt::ICore::Instance().GetRootDirectory().ToString() + "/cache/angelscript/startup/" + name + ".json");
 
     return true;
 }
 
-alt::String AngelScriptResource::ReadFile(alt::String path)
+asIScriptModule* AngelScriptResource::BuildModule(CScriptBuilder& builder, const std::string& moduleName)
+{
+    auto engine = runtime->GetEngine();
+    std::string name = resource->GetName().ToString();
+
+    int r = PrepareBuilder(builder, moduleName);
+    CHECK_AS_RETURN("Builder start", r, nullptr);
+
+    // The pragmas are known after preprocessing, the functions are jit compiled while building or loading the module
+    auto& jit = runtime->GetJITCompiler();
+    jit.SetEnabled(moduleName, build.settings.jit, build.settings.jitAll);
+    if(build.settings.jit && !jit.IsAvailable())
+    {
+        Log::Warning << "Resource '" << name << "' enabled the JIT, but the module was built without a JIT backend. The scripts are interpreted" << Log::Endl;
+    }
+
+    // Try to load the bytecode from the cache first
+    Helpers::BytecodeCache cache(alt::ICore::Instance().GetRootDirectory().ToString() + "/cache/angelscript/" + name + ".asbc");
+    asIScriptModule* mod = nullptr;
+    if(cache.IsUpToDate(build.sourceHash, runtime->GetInterfaceHash()))
+    {
+        int64_t loadStart = GetTime();
+        // Replaces the module created by the builder, the parsed sections are not needed when loading bytecode
+        mod = engine->GetModule(moduleName.c_str(), asGM_ALWAYS_CREATE);
+        bool loaded;
+        {
+            Helpers::PhaseTimings::Scope scope(startupTimings, "Load bytecode");
+            loaded = cache.Load(mod);
+        }
+        if(loaded)
+        {
+            int64_t loadTime = GetTime() - loadStart;
+            int64_t saved = std::max<int64_t>(cache.GetCompileTime() - loadTime, 0);
+            Log::Info << "Bytecode cache hit for resource '" << name << "', loaded in " << std::to_string(loadTime) << "ms (saved " << std::to_string(saved) << "ms)" << Log::Endl;
+        }
+        else
+        {
+            // The builder module was discarded, so the sections have to be added again
+            mod = nullptr;
+            r = PrepareBuilder(builder, moduleName);
+            CHECK_AS_RETURN("Builder start", r, nullptr);
+        }
+    }
+    if(mod == nullptr)
+    {
+        // The cache is missing or stale, so do a full compile
+        int64_t compileStart = GetTime();
+        {
+            Helpers::PhaseTimings::Scope scope(startupTimings, "Compile");
+            r = builder.BuildModule();
+        }
+        CHECK_AS_RETURN("Compilation", r, nullptr);
+        uint32_t compileTime = (uint32_t)(GetTime() - compileStart);
+
+        mod = builder.GetModule();
+        {
+            Helpers::PhaseTimings::Scope scope(startupTimings, "Save bytecode");
+            cache.Save(mod, build.sourceHash, runtime->GetInterfaceHash(), compileTime);
+        }
+        Log::Info << "Bytecode cache miss for resource '" << name << "', compiled in " << std::to_string(compileTime) << "ms" << Log::Endl;
+    }
+
+    // The sources are not needed anymore, so don't keep the files open
+    includeResolver.ReleaseFiles();
+    jit.Finalize();
+
+    return mod;
+}
+
+int AngelScriptResource::PrepareBuilder(CScriptBuilder& builder, const std::string& moduleName)
+{
+    // Reading files and resolving includes happens during preprocessing, but is reported separately
+    int64_t start = startupTimings.GetElapsed();
+    int64_t nested = startupTimings.Get("Read files") + startupTimings.Get("Resolve includes");
+
+    builder.SetIncludeCallback(Helpers::IncludeHandler, this);
+    builder.SetPragmaCallback(Helpers::PragmaHandler, this);
+
+    int r = builder.StartNewModule(runtime->GetEngine(), moduleName.c_str());
+    if(r < 0) return r;
+
+    build = BuildState();
+    includeResolver.BeginBuild();
+    r = AddScriptSection(&builder, Helpers::IncludeResolver::Normalize(resource->GetMain().ToString()));
+
+    nested = startupTimings.Get("Read files") + startupTimings.Get("Resolve includes") - nested;
+    startupTimings.Add("Preprocess", startupTimings.GetElapsed() - start - nested);
+    return r;
+}
+
+int AngelScriptResource::AddScriptSection(CScriptBuilder* builder, const std::string& path)
+{
+    includeResolver.AddFile(path);
+    const Helpers::File* src;
+    {
+        Helpers::PhaseTimings::Scope scope(startupTimings, "Read files");
+        src = includeResolver.GetFile(path);
+    }
+    if(src == nullptr)
+    {
+        Log::Error << "Script file '" << path << "' not found" << Log::Endl;
+        return -1;
+    }
+
+    int r = builder->AddSectionFromMemory(path.c_str(), src->GetData(), src->GetSize());
+    // Sections that were already included before are skipped by the builder
+    if(r > 0)
+    {
+        uint64_t hash = Helpers::Hash64(src->GetData(), src->GetSize());
+        includeResolver.SetFileHash(path, hash);
+        // Both the name and the content of the section affect the compiled module
+        build.sourceHash = Helpers::Hash64(path, build.sourceHash);
+        build.sourceHash = Helpers::Hash64(&hash, sizeof(hash), build.sourceHash);
+    }
+    return r;
+}
+
+void AngelScriptResource::CommitBuild()
+{
+    settings = build.settings;
+    includeResolver.CommitBuild();
+}
+
+int AngelScriptResource::Execute(asIScriptContext* context)
+{
+    if(settings.budget == 0) return context->Execute();
+
+    auto& watchdog = runtime->GetWatchdog();
+    watchdog.Begin(context, settings.budget);
+    int r = context->Execute();
+    // The watchdog suspends the context, so the callstack can still be logged before aborting
+    if(watchdog.End(r == asEXECUTION_SUSPENDED))
+    {
+        // The suspend can race with a coroutine suspending itself, which already queued its context
+        coroutines.Remove(context);
+        Log::Error << "Script call of resource '" << resource->GetName().ToString() << "' exceeded the execution budget of " << std::to_string(settings.budget) << "ms and was aborted. Callstack:" << Log::Endl;
+        Log::Error << Helpers::Watchdog::GetCallstack(context) << Log::Endl;
+        context->Abort();
+        r = asEXECUTION_ABORTED;
+    }
+    return r;
+}
+
+void AngelScriptResource::WatchFiles()
 {
-    auto pkg = resource->GetPackage();
-    // Check if file exists
-    if(!pkg->FileExists(path)) return alt::String();
-    // Open file
-    alt::IPackage::File* pkgFile = pkg->OpenFile(path);
-    alt::String src(pkg->GetFileSize(pkgFile));
-    // Read file content
-    pkg->ReadFile(pkgFile, src.GetData(), src.GetSize());
-    pkg->CloseFile(pkgFile);
-
-    return src;
+    // Watching is only done in debug mode, as it is meant for development
+    if(!alt::ICore::Instance().IsDebug()) return;
+
+    std::unordered_map<std::string, uint64_t> paths;
+    std::string root = resource->GetPath().ToString() + "/";
+    for(auto& path : includeResolver.GetAllDependencies(Helpers::IncludeResolver::Normalize(resource->GetMain().ToString())))
+    {
+        std::string absolutePath = std::filesystem::path(root + path).lexically_normal().string();
+        paths[absolutePath] = includeResolver.GetFileHash(path);
+    }
+    runtime->GetFileWatcher().Watch(this, paths);
 }
 
 bool AngelScriptResource::Stop()
 {
+    runtime->GetFileWatcher().Unwatch(this);
+    runtime->GetJITCompiler().SetEnabled(resource->GetName().ToString(), false);
+
     // Gets Stop function and if exists calls it
     if(module != nullptr)
     {
         asIScriptFunction* func = module->GetFunctionByDecl("void Stop()");
-        if(func != 0 && context != nullptr)
+        if(func != 0)
         {
-            auto r = context->Prepare(func);
-            CHECK_AS_RETURN("Stop function call", r, false);
+            auto context = contextPool.Prepare(func);
+            if(context == nullptr) return false;
 
-            context->Execute();
+            Execute(context);
+            contextPool.Return(context);
         }
         module->Discard();
     }
 
-    if(context != nullptr) context->Release();
+    coroutines.Clear();
+    contextPool.Clear();
+
+    // Release the timer callbacks
+    timers.Clear();
+    timerQueue = {};
+    everyTickCallbacks.Clear();
+    nextTickCallbacks.Clear();
+
+    if(timerStats.deferred != 0)
+    {
+        Log::Info << "Resource '" << resource->GetName().ToString() << "' deferred " << std::to_string(timerStats.deferred) << " of "
+            << std::to_string(timerStats.executed + timerStats.deferred) << " timer runs in " << std::to_string(timerStats.busyTicks)
+            << " ticks because of the tick budget (max delay " << std::to_string(timerStats.maxDelay) << "ms)" << Log::Endl;
+    }
 
     // Release the event handler script functions to not create a memory leak
-    for(auto pair : eventHandlers)
+    for(auto& handlers : eventHandlers) handlers.Clear();
+
+    for(auto& kv : rejectedCustomEvents)
+    {
+        if(kv.second > 1)
+        {
+            Log::Warning << "Rejected " << std::to_string(kv.second) << " custom events in total for handler '" << kv.first->GetDeclaration() << "'" << Log::Endl;
+        }
+        kv.first->Release();
+    }
+    rejectedCustomEvents.clear();
+
+    // The lists release their handlers when they are destroyed
+    customEventHandlers.clear();
+    customEventNames.Clear();
+    if(customEventArgs != nullptr)
+    {
+        customEventArgs->Release();
+        customEventArgs = nullptr;
+    }
+
+    return true;
+}
+
+bool AngelScriptResource::HotReload()
+{
+    int64_t start = GetTime();
+    std::string name = resource->GetName().ToString();
+
+    startupTimings.Reset();
+
+    // Build the new module next to the current one, so the resource keeps running if the build fails
+    CScriptBuilder builder;
+    std::string reloadName = name + ".reload";
+    asIScriptModule* newModule = BuildModule(builder, reloadName);
+    bool swapped = newModule != nullptr && SwapModule(newModule);
+    runtime->GetJITCompiler().SetEnabled(reloadName, false);
+    if(!swapped)
     {
-        pair.second->Release();
+        runtime->GetEngine()->DiscardModule(reloadName.c_str());
+        Log::Error << "Hot reload of resource '" << name << "' failed, the current version keeps running" << Log::Endl;
+        return false;
     }
-    eventHandlers.clear();
 
-    for(auto kv : customLocalEventHandlers)
+    CommitBuild();
+    runtime->GetJITCompiler().SetEnabled(name, settings.jit, settings.jitAll);
+    WatchFiles();
+    Log::Colored << "~g~Hot reloaded resource ~w~" << name << "~g~ in ~w~" << std::to_string(GetTime() - start) << "ms" << Log::Endl;
+    return true;
+}
+
+bool AngelScriptResource::SwapModule(asIScriptModule* newModule)
+{
+    CSerializer serializer;
+    Helpers::RegisterSerializerTypes(serializer);
+
+    // Script objects only referenced by delegates are not reachable from the globals, so store them explicitly
+    auto storeDelegateObject = [&](asIScriptFunction* func) {
+        if(func->GetFuncType() != asFUNC_DELEGATE) return;
+        if((func->GetDelegateObjectType()->GetFlags() & asOBJ_SCRIPT_OBJECT) == 0) return;
+        serializer.AddExtraObjectToStore(static_cast<asIScriptObject*>(func->GetDelegateObject()));
+    };
+    for(auto& handlers : eventHandlers) handlers.ForEach(storeDelegateObject);
+    for(auto& handlers : customEventHandlers) handlers.ForEach(storeDelegateObject);
+    timers.ForEach([&](uint32_t id, Helpers::Timer& timer) { storeDelegateObject(timer.GetCallback()); });
+    everyTickCallbacks.ForEach(storeDelegateObject);
+    nextTickCallbacks.ForEach(storeDelegateObject);
+
+    int r = serializer.Store(module);
+    CHECK_AS_RETURN("Storing script state", r, false);
+    for(asUINT i = 0; i < module->GetGlobalVarCount(); i++)
     {
-        kv.second->Release();
+        const char* varName;
+        const char* varNamespace;
+        int typeId;
+        module->GetGlobalVar(i, &varName, &varNamespace, &typeId);
+        if(Helpers::IsSerializableType(runtime->GetEngine(), typeId)) continue;
+        Log::Warning << "Global '" << module->GetGlobalVarDeclaration(i, true) << "' can't be kept over the hot reload and is reset" << Log::Endl;
     }
-    customLocalEventHandlers.clear();
+    r = serializer.Restore(newModule);
+    CHECK_AS_RETURN("Restoring script state", r, false);
 
-    for(auto kv : customRemoteEventHandlers)
+    // Suspended coroutines are in the middle of functions of the old module, so they can't be kept
+    if(coroutines.GetCount() != 0)
     {
-        kv.second->Release();
+        Log::Warning << "Aborting " << std::to_string(coroutines.GetCount()) << " suspended coroutines for the hot reload" << Log::Endl;
+        coroutines.Clear();
     }
-    customRemoteEventHandlers.clear();
 
+    // Point all handlers to the functions of the new module
+    auto rebindCallback = [&](asIScriptFunction*& callback) {
+        callback = RebindFunction(callback, newModule, serializer);
+    };
+    for(auto& handlers : eventHandlers) handlers.ForEach(rebindCallback);
+    for(auto& handlers : customEventHandlers) handlers.ForEach(rebindCallback);
+    timers.ForEach([&](uint32_t id, Helpers::Timer& timer) {
+        auto callback = RebindFunction(timer.GetCallback(), newModule, serializer);
+        timer.SetCallback(callback);
+        // Removing doesn't move the other timers, so it is safe while iterating
+        if(callback == nullptr) RemoveTimer(id);
+    });
+    everyTickCallbacks.ForEach(rebindCallback);
+    nextTickCallbacks.ForEach(rebindCallback);
+
+    std::string name = module->GetName();
+    module->Discard();
+    newModule->SetName(name.c_str());
+    module = newModule;
     return true;
 }
 
+asIScriptFunction* AngelScriptResource::RebindFunction(asIScriptFunction* func, asIScriptModule* newModule, CSerializer& serializer)
+{
+    asIScriptFunction* result = nullptr;
+    if(func->GetFuncType() == asFUNC_DELEGATE && (func->GetDelegateObjectType()->GetFlags() & asOBJ_SCRIPT_OBJECT))
+    {
+        // Bind the method of the new class to the restored object
+        auto object = static_cast<asIScriptObject*>(serializer.GetPointerToRestoredObject(func->GetDelegateObject()));
+        if(object != nullptr)
+        {
+            auto method = object->GetObjectType()->GetMethodByDecl(func->GetDelegateFunction()->GetDeclaration(false));
+            if(method != nullptr) result = runtime->GetEngine()->CreateDelegate(method, object);
+        }
+    }
+    else if(func->GetFuncType() != asFUNC_DELEGATE && func->GetModule() == module)
+    {
+        newModule->SetDefaultNamespace(func->GetNamespace());
+        result = newModule->GetFunctionByDecl(func->GetDeclaration(false));
+        newModule->SetDefaultNamespace("");
+        if(result != nullptr) result->AddRef();
+    }
+    else
+    {
+        // Not part of the script module (e.g. delegate of an application object), so it stays valid
+        result = func;
+        result->AddRef();
+    }
+
+    if(result == nullptr)
+    {
+        Log::Warning << "'" << func->GetDeclaration(true, true) << "' does not exist anymore after the hot reload, removing the handler" << Log::Endl;
+    }
+    func->Release();
+    return result;
+}
+
 bool AngelScriptResource::OnEvent(const alt::CEvent* ev)
 {
     if(ev->GetType() == alt::CEvent::Type::SERVER_SCRIPT_EVENT)
@@ -128,6 +418,10 @@ bool AngelScriptResource::OnEvent(const alt::CEvent* ev)
         HandleCustomEvent(ev, false);
         return true;
     }
+    // Get all script callbacks for the event
+    // Most events have no handler, so return before the args are converted
+    auto& callbacks = GetEventHandlers(ev->GetType());
+    if(callbacks.IsEmpty()) return true;
     // Get the handler for the specified event
     auto event = Helpers::Event::GetEvent(ev->GetType());
     if(event == nullptr)
@@ -135,112 +429,272 @@ bool AngelScriptResource::OnEvent(const alt::CEvent* ev)
         Log::Error << "Unhandled event type " << std::to_string((uint16_t)ev->GetType()) << Log::Endl;
         return true;
     }
-    // Get all script callbacks for the event
-    auto callbacks = GetEventHandlers(ev->GetType());
-    // Get the args for the event
-    auto args = event->GetArgs(this, ev);
-    auto returnType = event->GetReturnType();
-    // If the return type of the event is bool, it should return a value
-    bool shouldReturn = strcmp(returnType, "bool") == 0;
-
-    // Loop over all script callbacks and call them with the args
-    for(auto callback : callbacks)
-    {
-        auto r = context->Prepare(callback);
-        CHECK_AS_RETURN("Prepare event handler", r, true);
-        for(int i = 0; i < args.size(); i++)
-        {
-            auto arg = args[i];
-            if(arg.second == true) context->SetArgAddress(i, arg.first);
-            else context->SetArgObject(i, arg.first);
-        }
-        r = context->Execute();
-        CHECK_AS_RETURN("Execute event handler", r, true);
-        if(r == asEXECUTION_FINISHED && shouldReturn)
-        {
-            auto result = context->GetReturnByte();
-            return result == 1 ? true : false;
-        }
+    return event->Handle(this, ev, callbacks);
+}
+
+bool AngelScriptResource::SetEventCombinePolicy(const std::string& eventName, const std::string& policyName)
+{
+    using Helpers::EventCombinePolicy;
+    auto event = Helpers::Event::GetEvent(eventName);
+    if(event == nullptr || event->GetReturnKind() != Helpers::EventReturnKind::BOOL)
+    {
+        Log::Error << "Invalid event '" << eventName << "' for pragma 'eventpolicy', expected an event whose handlers return bool" << Log::Endl;
+        return false;
     }
 
+    EventCombinePolicy policy;
+    if(policyName == "firstfalse") policy = EventCombinePolicy::FIRST_FALSE_CANCELS;
+    else if(policyName == "all") policy = EventCombinePolicy::ALL_MUST_AGREE;
+    else if(policyName == "last") policy = EventCombinePolicy::LAST_WINS;
+    else
+    {
+        Log::Error << "Invalid value '" << policyName << "' for pragma 'eventpolicy', expected 'firstfalse', 'all' or 'last'" << Log::Endl;
+        return false;
+    }
+    build.settings.eventPolicies[event->GetType()] = policy;
     return true;
 }
 
+bool AngelScriptResource::CallEventHandlers(Helpers::EventHandlerList& handlers, Helpers::EventReturnKind returnKind, Helpers::EventCombinePolicy policy, EventArgsSetter setArgs, const void* args)
+{
+    using Helpers::EventCombinePolicy;
+    bool result = true;
+
+    // Handlers registered while the handlers run are only called for the next event
+    handlers.Run([&](asIScriptFunction* callback) {
+        auto context = contextPool.Prepare(callback);
+        if(context == nullptr) return false;
+        setArgs(context, args);
+        auto r = Execute(context);
+        // The return value has to be read before the context is given back
+        // Cancellable events also have void handlers, only the ones registered as cancellable return a value
+        bool returned = r == asEXECUTION_FINISHED && returnKind == Helpers::EventReturnKind::BOOL && callback->GetReturnTypeId() == asTYPEID_BOOL;
+        bool value = returned && context->GetReturnByte() == 1;
+        contextPool.Return(context);
+        CHECK_AS_RETURN("Execute event handler", r, false);
+        if(!returned) return true;
+
+        switch(policy)
+        {
+            case EventCombinePolicy::FIRST_FALSE_CANCELS:
+            {
+                result = value;
+                return value;
+            }
+            case EventCombinePolicy::ALL_MUST_AGREE:
+            {
+                result = result && value;
+                return true;
+            }
+            case EventCombinePolicy::LAST_WINS:
+            {
+                result = value;
+                return true;
+            }
+        }
+        return true;
+    });
+
+    return result;
+}
+
 void AngelScriptResource::HandleCustomEvent(const alt::CEvent* event, bool local)
 {
-    std::string name;
-    alt::MValueArgs args;
+    uint32_t eventId;
+    // Names that were never registered are not interned, so unhandled events return without allocating
     if(local)
     {
         auto ev = static_cast<const alt::CServerScriptEvent*>(event);
-        name = ev->GetName().ToString();
-        args = ev->GetArgs();
-        CScriptArray* array = runtime->CreateAnyArray(args.GetSize());
-        std::vector<asIScriptFunction*> handlers = GetCustomEventHandlers(name, true);
-        for(int i = 0; i < args.GetSize(); i++)
-        {
-            CScriptAny* any = new CScriptAny(runtime->GetEngine());
-            auto arg = args[i];
-            std::pair<int, void*> converted = Helpers::MValueToValue(runtime, arg);
-            any->Store(converted.second, converted.first);
-            array->SetValue(i, (void*)any);
-            // Free the memory again
-            if(converted.first != runtime->GetBaseObjectTypeId()) delete converted.second;
-        }
-        for(auto handler : handlers)
-        {
-            auto r = context->Prepare(handler);
-            CHECK_AS_RETURN("Prepare custom event handler", r);
-            context->SetArgObject(0, array);
-            r = context->Execute();
-            CHECK_AS_RETURN("Execute custom event handler", r);
-        }
+        eventId = FindCustomEvent(ev->GetName().CStr());
+        if(eventId == Helpers::EventNameTable::INVALID_ID) return;
+        CallCustomEventHandlers(eventId, true, nullptr, ev->GetArgs());
     }
     else
     {
-        alt::Ref<alt::IPlayer> player;
         auto ev = static_cast<const alt::CClientScriptEvent*>(event);
-        name = ev->GetName().ToString();
-        args = ev->GetArgs();
-        player = ev->GetTarget();
-        CScriptArray* array = runtime->CreateAnyArray(args.GetSize());
-        std::vector<asIScriptFunction*> handlers = GetCustomEventHandlers(name, false);
-        for(int i = 0; i < args.GetSize(); i++)
-        {
-            CScriptAny* any = new CScriptAny(runtime->GetEngine());
-            auto arg = args[i];
-            std::pair<int, void*> converted = Helpers::MValueToValue(runtime, arg);
-            any->Store(converted.second, converted.first);
-            array->SetValue(i, (void*)any);
-            // Free the memory again
-            if(converted.first != runtime->GetBaseObjectTypeId()) delete converted.second;
-        }
-        for(auto handler : handlers)
-        {
-            auto r = context->Prepare(handler);
-            CHECK_AS_RETURN("Prepare custom event handler", r);
-            context->SetArgObject(0, player.Get());
-            context->SetArgObject(1, array);
-            r = context->Execute();
-            CHECK_AS_RETURN("Execute custom event handler", r);
-        }
+        eventId = FindCustomEvent(ev->GetName().CStr());
+        if(eventId == Helpers::EventNameTable::INVALID_ID) return;
+        CallCustomEventHandlers(eventId, false, ev->GetTarget().Get(), ev->GetArgs());
+    }
+    coroutines.NotifyEvent(eventId);
+}
+
+void AngelScriptResource::CallCustomEventHandlers(uint32_t eventId, bool local, alt::IPlayer* player, const alt::MValueArgs& args)
+{
+    // The remote handlers get the player who sent the event before the args
+    asUINT firstArg = local ? 0 : 1;
+
+    // The args are only converted if there are handlers, waiting coroutines don't get them
+    auto& handlers = GetCustomEventHandlers(eventId, local);
+    if(!handlers.IsEmpty())
+    {
+        CScriptArray* array = ConvertCustomEventArgs(args);
+        handlers.Run([&](asIScriptFunction* handler) {
+            auto context = contextPool.Prepare(handler);
+            if(context == nullptr) return false;
+            if(!local) context->SetArgObject(0, player);
+            context->SetArgObject(firstArg, array);
+            auto r = Execute(context);
+            contextPool.Return(context);
+            CHECK_AS_RETURN("Execute custom event handler", r, false);
+            return true;
+        });
+        ReleaseCustomEventArgs(array);
+    }
+
+    auto& typedHandlers = GetCustomEventHandlers(eventId, local, true);
+    if(!typedHandlers.IsEmpty())
+    {
+        Helpers::TypedEventArgs typedArgs(runtime, args);
+        std::string error;
+        typedHandlers.Run([&](asIScriptFunction* handler) {
+            auto context = contextPool.Prepare(handler);
+            if(context == nullptr) return false;
+            if(!local) context->SetArgObject(0, player);
+            if(!typedArgs.SetArgs(context, handler, firstArg, error))
+            {
+                contextPool.Return(context);
+                auto rejected = rejectedCustomEvents.emplace(handler, 0);
+                if(rejected.second)
+                {
+                    handler->AddRef();
+                    Log::Error << "Rejected custom event '" << customEventNames.GetName(eventId) << "' for handler '"
+                        << handler->GetDeclaration() << "': " << error << ". Further rejections for this handler are only counted" << Log::Endl;
+                }
+                rejected.first->second++;
+                return true;
+            }
+            auto r = Execute(context);
+            contextPool.Return(context);
+            CHECK_AS_RETURN("Execute custom event handler", r, false);
+            return true;
+        });
+    }
+}
+
+CScriptArray* AngelScriptResource::ConvertCustomEventArgs(const alt::MValueArgs& args)
+{
+    // Taken out of the cache while in use, so an event emitted by a handler gets its own array
+    CScriptArray* array = customEventArgs;
+    customEventArgs = nullptr;
+    if(array == nullptr) array = runtime->CreateAnyArray(args.GetSize());
+    else array->Resize(args.GetSize());
+
+    // The anys are the elements of the array, so they are reused too
+    for(asUINT i = 0; i < args.GetSize(); i++)
+    {
+        auto arg = args[i];
+        Helpers::MValueToAny(runtime, arg, static_cast<CScriptAny*>(array->At(i)));
     }
+    return array;
+}
+
+void AngelScriptResource::ReleaseCustomEventArgs(CScriptArray* array)
+{
+    // array<any> and any are garbage collected, the garbage collector holds a reference to each of them too
+    auto arrayType = array->GetArrayObjectType();
+    int arrayRefs = (arrayType->GetFlags() & asOBJ_GC) ? 2 : 1;
+    int anyRefs = (arrayType->GetSubType()->GetFlags() & asOBJ_GC) ? 2 : 1;
+
+    bool reusable = customEventArgs == nullptr && array->GetRefCount() == arrayRefs;
+    for(asUINT i = 0; reusable && i < array->GetSize(); i++)
+    {
+        auto any = static_cast<CScriptAny*>(array->At(i));
+        // A script kept a handle to the any
+        if(any->GetRefCount() != anyRefs) reusable = false;
+        // Don't keep the values alive (e.g. players) until the next event
+        else any->Store(nullptr, asTYPEID_VOID);
+    }
+    if(!reusable)
+    {
+        array->Release();
+        return;
+    }
+    customEventArgs = array;
 }
 
 void AngelScriptResource::OnTick()
 {
-    // Remove all invalid timers
-    for (auto &id : invalidTimers) timers.erase(id);
-    invalidTimers.clear();
+    if(hotReloadPending)
+    {
+        hotReloadPending = false;
+        HotReload();
+    }
 
-    // Update timers
-    for(auto& timer : timers)
+    // The clock is only read once per tick
+    int64_t time = GetTime();
+    coroutines.Update(time);
+
+    // Tick callbacks run before the timers and are never deferred
+    auto runTickCallback = [&](asIScriptFunction* callback) {
+        auto context = contextPool.Prepare(callback);
+        if(context == nullptr) return;
+        Execute(context);
+        contextPool.Return(context);
+    };
+    nextTickCallbacks.Run(runTickCallback);
+    everyTickCallbacks.Run(runTickCallback);
+
+    UpdateTimers(time);
+}
+
+void AngelScriptResource::UpdateTimers(int64_t time)
+{
+    // Collect the due timers first, the callbacks can create and remove timers
+    // Popped in order of their deadline, so the longest waiting timers come first
+    std::vector<uint32_t> high, normal;
+    while(!timerQueue.empty() && timerQueue.top().nextRun <= time)
     {
-        int64_t time = GetTime();
-        if(!timer.second->Update(time))
+        uint32_t id = timerQueue.top().id;
+        timerQueue.pop();
+        auto timer = timers.Get(id);
+        if(timer == nullptr) continue;
+        if(timer->GetPriority() == Helpers::Timer::Priority::HIGH) high.push_back(id);
+        else normal.push_back(id);
+    }
+    if(high.empty() && normal.empty()) return;
+
+    auto run = [&](uint32_t id) {
+        // The timer could have been cleared by a callback that ran before
+        auto timer = timers.Get(id);
+        if(timer == nullptr) return;
+        timerStats.maxDelay = std::max(timerStats.maxDelay, timer->GetDelay(time));
+        timerStats.executed++;
+
+        auto context = contextPool.Prepare(timer->GetCallback());
+        if(context != nullptr)
         {
-            RemoveTimer(timer.first);
+            timer->SetContextArgs(context);
+            Execute(context);
+            contextPool.Return(context);
+        }
+
+        // The slab can grow while the callback runs, so the timer has to be looked up again
+        timer = timers.Get(id);
+        if(timer == nullptr) return;
+        if(timer->Reschedule(time)) timerQueue.push({timer->GetNextRun(), id});
+        else RemoveTimer(id);
+    };
+
+    // Latency sensitive timers are never deferred
+    for(auto id : high) run(id);
+
+    for(size_t i = 0; i < normal.size(); i++)
+    {
+        // At least one timer runs per tick, so the timers always make progress
+        if(i != 0 && settings.tickBudget != 0 && GetTime() - time >= settings.tickBudget)
+        {
+            // Deferred timers keep their deadline, so they are the first ones to run on the next tick
+            for(size_t n = i; n < normal.size(); n++)
+            {
+                auto timer = timers.Get(normal[n]);
+                if(timer != nullptr) timerQueue.push({timer->GetNextRun(), normal[n]});
+            }
+            timerStats.deferred += normal.size() - i;
+            timerStats.busyTicks++;
+            break;
         }
+        run(normal[i]);
     }
 }
 
@@ -3,31 +3,146 @@
 #include "cpp-sdk/SDK.h"
 #include "Log.h"
 #include "helpers/timer.h"
+#include "helpers/tick.h"
+#include "helpers/handlers.h"
+#include "helpers/include.h"
+#include "helpers/file.h"
+#include "helpers/timings.h"
+#include "helpers/context.h"
+#include "helpers/coroutine.h"
+#include "helpers/hash.h"
+#include "helpers/clock.h"
+#include <atomic>
+#include <queue>
+#include <array>
+#include <deque>
+#include <unordered_map>
+#include <string_view>
 #include "angelscript/include/angelscript.h"
 #include "angelscript/addon/scriptarray/scriptarray.h"
 #include "angelscript/addon/scriptbuilder/scriptbuilder.h"
 #include "angelscript/addon/scripthelper/scripthelper.h"
 
+class CSerializer;
 class AngelScriptRuntime;
 class AngelScriptResource : public alt::IResource::Impl
 {  
     AngelScriptRuntime* runtime;
     alt::IResource* resource;
     asIScriptModule* module = nullptr;
-    asIScriptContext* context = nullptr;
+    Helpers::ContextPool contextPool;
+    Helpers::CoroutineScheduler coroutines{this};
+
+    Helpers::IncludeResolver includeResolver{this};
+
+    // Settings of the resource, set by '#pragma' directives in the scripts
+    struct Settings
+    {
+        // Compile the hot script functions to native code
+        bool jit = false;
+        // Compile all script functions instead of only the hot ones
+        bool jitAll = false;
+        // Max time in ms a single script call may take before it is aborted, 0 = unlimited
+        uint32_t budget = 0;
+        // Max time in ms the timers may take per tick before the remaining ones are deferred, 0 = unlimited
+        uint32_t tickBudget = 0;
+        // Combine policies of bool events overridden by the resource, set by '#pragma eventpolicy'
+        std::unordered_map<alt::CEvent::Type, Helpers::EventCombinePolicy> eventPolicies;
+    } settings;
+
+    // State collected while building the module, only taken over once the build succeeded
+    // so a failed hot reload keeps the settings of the module that is still running
+    struct BuildState
+    {
+        Settings settings;
+        // Hash of all script sections added to the builder, used as key for the bytecode cache
+        uint64_t sourceHash = Helpers::HASH64_OFFSET_BASIS;
+    } build;
+
+public:
+    // How much timer work was deferred to later ticks because of the tick budget
+    struct TimerStats
+    {
+        uint64_t executed = 0;
+        uint64_t deferred = 0;
+        // Ticks in which at least one timer was deferred
+        uint64_t busyTicks = 0;
+        // Longest time a timer had to wait after it was due in ms
+        int64_t maxDelay = 0;
+    };
+
+private:
+    TimerStats timerStats;
+
+    // Durations of the startup phases, reported after the resource started
+    Helpers::PhaseTimings startupTimings{"resource"};
+
+    // Whether a hot reload should be done on the next tick, set by the file watcher thread
+    std::atomic<bool> hotReloadPending{false};
+
+    // Gets the function equivalent to the given one in the new module, releases the old function
+    // Returns nullptr if the function does not exist anymore
+    asIScriptFunction* RebindFunction(asIScriptFunction* func, asIScriptModule* newModule, CSerializer& serializer);
 
     // Timers
-    std::unordered_map<uint32_t, Helpers::Timer*> timers;
-    std::vector<uint32_t> invalidTimers;
-    uint32_t nextTimerId = 1;
+    struct ScheduledTimer
+    {
+        int64_t nextRun;
+        uint32_t id;
+
+        bool operator>(const ScheduledTimer& other) const
+        {
+            if(nextRun != other.nextRun) return nextRun > other.nextRun;
+            return id > other.id;
+        }
+    };
+    Helpers::TimerSlab timers;
+    // Ordered by the next run, so a tick only touches the due timers
+    // Entries of removed timers are skipped when they come up
+    std::priority_queue<ScheduledTimer, std::vector<ScheduledTimer>, std::greater<ScheduledTimer>> timerQueue;
+    // EveryTick and NextTick callbacks, they don't need any scheduling
+    Helpers::TickQueue everyTickCallbacks{false};
+    Helpers::TickQueue nextTickCallbacks{true};
+
+    // Ids of all event handlers, declared before the handler lists as they free their slots when destroyed
+    Helpers::EventHandlerSlots eventHandlerSlots;
+    // Script callbacks indexed by the event type
+    std::array<Helpers::EventHandlerList, (size_t)alt::CEvent::Type::SIZE> eventHandlers;
+    // Custom event names interned to ids, the handler lists are indexed by them
+    Helpers::EventNameTable customEventNames;
+    struct CustomEventHandlers
+    {
+        Helpers::EventHandlerList local;
+        Helpers::EventHandlerList remote;
+        // Handlers that get the args as their typed params instead of an array<any>
+        Helpers::EventHandlerList typedLocal;
+        Helpers::EventHandlerList typedRemote;
 
-    // first = event type, second = script callback
-    std::vector<std::pair<alt::CEvent::Type, asIScriptFunction*>> eventHandlers;
-    std::unordered_multimap<std::string, asIScriptFunction*> customLocalEventHandlers;
-    std::unordered_multimap<std::string, asIScriptFunction*> customRemoteEventHandlers;
+        CustomEventHandlers(Helpers::EventHandlerSlots* slots) : local(slots), remote(slots), typedLocal(slots), typedRemote(slots) {};
+
+        template<typename Func>
+        void ForEach(Func func)
+        {
+            for(auto handlers : { &local, &remote, &typedLocal, &typedRemote }) handlers->ForEach(func);
+        }
+    };
+    // A deque doesn't move the lists when it grows, the slots point to them
+    std::deque<CustomEventHandlers> customEventHandlers;
+    // Args array of the last custom event, reused by the next one if no script kept a reference to it
+    CScriptArray* customEventArgs = nullptr;
+    // How often the events for a typed handler were rejected, only the first rejection is logged
+    // so clients sending wrong args can't flood the log, the handlers are referenced until the resource stops
+    std::unordered_map<asIScriptFunction*, uint64_t> rejectedCustomEvents;
+    // Converts the args into an array shared by all handlers of the event
+    CScriptArray* ConvertCustomEventArgs(const alt::MValueArgs& args);
+    // Releases the args array, or keeps it for the next event
+    void ReleaseCustomEventArgs(CScriptArray* array);
 
 public:
-    AngelScriptResource(AngelScriptRuntime* runtime, alt::IResource* resource) : runtime(runtime), resource(resource) {};
+    AngelScriptResource(AngelScriptRuntime* runtime, alt::IResource* resource) : runtime(runtime), resource(resource)
+    {
+        for(auto& handlers : eventHandlers) handlers.Init(&eventHandlerSlots);
+    };
     ~AngelScriptResource() = default;
 
     alt::IResource* GetResource()
@@ -38,82 +153,186 @@ public:
     {
         return runtime;
     }
-    asIScriptContext* GetContext()
+    Helpers::ContextPool& GetContextPool()
     {
-        return context;
+        return contextPool;
+    }
+    Helpers::CoroutineScheduler& GetCoroutines()
+    {
+        return coroutines;
     }
     asIScriptModule* GetModule()
     {
         return module;
     }
+    Helpers::IncludeResolver& GetIncludeResolver()
+    {
+        return includeResolver;
+    }
+    // Settings of the build in progress, the pragmas are applied to these
+    Settings& GetBuildSettings()
+    {
+        return build.settings;
+    }
+    // Sets the combine policy of the bool event for the build in progress, returns false if the names are invalid
+    bool SetEventCombinePolicy(const std::string& eventName, const std::string& policyName);
+    Helpers::EventCombinePolicy GetEventCombinePolicy(alt::CEvent::Type event, Helpers::EventCombinePolicy defaultPolicy)
+    {
+        auto it = settings.eventPolicies.find(event);
+        return it == settings.eventPolicies.end() ? defaultPolicy : it->second;
+    }
+    Helpers::PhaseTimings& GetStartupTimings()
+    {
+        return startupTimings;
+    }
 
     // Returns the main function if found, otherwise nullptr
     asIScriptFunction* RegisterMetadata(CScriptBuilder& builder);
 
-    alt::String ReadFile(alt::String path);
+    // Opens the file of the resource, returns an invalid file if it does not exist
+    Helpers::File ReadFile(const std::string& path)
+    {
+        // In debug mode the files are edited while the resource runs and hot reloads, so they are not mapped
+        return Helpers::File::Open(resource, path, alt::ICore::Instance().IsDebug());
+    }
+    bool FileExists(const std::string& path)
+    {
+        return resource->GetPackage()->FileExists(path);
+    }
+
+    // Compiles the resource into a new module, or loads it from the bytecode cache if possible
+    // Returns nullptr if the build failed
+    asIScriptModule* BuildModule(CScriptBuilder& builder, const std::string& moduleName);
+    // Starts a new module in the builder and adds the main file (and its includes) to it
+    int PrepareBuilder(CScriptBuilder& builder, const std::string& moduleName);
+    // Adds the file as a new script section, the path has to be normalized
+    int AddScriptSection(CScriptBuilder* builder, const std::string& path);
+    // Takes over the settings and the dependencies of the last build, called once its module is in use
+    void CommitBuild();
 
-    // Registers a new script callback for the specified event
-    void RegisterEventHandler(alt::CEvent::Type event, asIScriptFunction* handler)
+    // Executes the prepared context, aborts the call if it exceeds the execution budget
+    int Execute(asIScriptContext* context);
+
+    // Registers a new script callback for the specified event, handlers with a higher priority run first
+    // Returns the id of the handler, 0 if it couldn't be added
+    uint32_t RegisterEventHandler(alt::CEvent::Type event, asIScriptFunction* handler, int32_t priority = 0)
     {
-        eventHandlers.push_back({event, handler});
+        return eventHandlers[(size_t)event].Add(handler, priority);
     }
     // Gets all script event handlers of the specified type
-    std::vector<asIScriptFunction*> GetEventHandlers(alt::CEvent::Type event)
+    Helpers::EventHandlerList& GetEventHandlers(alt::CEvent::Type event)
     {
-        std::vector<asIScriptFunction*> events;
-        for(auto handler : eventHandlers)
-        {
-            if(handler.first == event) events.push_back(handler.second);
-        }
-        return events;
+        return eventHandlers[(size_t)event];
     }
     
-    void RegisterCustomEventHandler(const std::string& name, asIScriptFunction* handler, bool local = true)
+    // Gets the id of the custom event name, the handler lists of the event are created with it
+    uint32_t InternCustomEvent(std::string_view name)
     {
-        if(local) customLocalEventHandlers.insert({name, handler});
-        else customRemoteEventHandlers.insert({name, handler});
+        uint32_t id = customEventNames.Intern(name);
+        while(customEventHandlers.size() <= id) customEventHandlers.emplace_back(&eventHandlerSlots);
+        return id;
     }
-    std::vector<asIScriptFunction*> GetCustomEventHandlers(const std::string& name, bool local = true)
+    // Returns INVALID_ID if nothing was ever registered for the custom event, doesn't allocate
+    uint32_t FindCustomEvent(std::string_view name)
     {
-        std::vector<asIScriptFunction*> arr;
-        if(local) 
-        {
-            auto range = customLocalEventHandlers.equal_range(name);
-            for (auto it = range.first; it != range.second; it++) arr.push_back(it->second);
-        }
-        else
-        {
-            auto range = customRemoteEventHandlers.equal_range(name);
-            for (auto it = range.first; it != range.second; it++) arr.push_back(it->second);
-        }
-        return arr;
+        return customEventNames.Find(name);
+    }
+    // Returns the id of the handler, 0 if it couldn't be added
+    uint32_t RegisterCustomEventHandler(const std::string& name, asIScriptFunction* handler, bool local = true, bool typed = false)
+    {
+        return GetCustomEventHandlers(InternCustomEvent(name), local, typed).Add(handler, 0);
+    }
+    // The id has to be interned
+    Helpers::EventHandlerList& GetCustomEventHandlers(uint32_t eventId, bool local = true, bool typed = false)
+    {
+        auto& handlers = customEventHandlers[eventId];
+        if(typed) return local ? handlers.typedLocal : handlers.typedRemote;
+        return local ? handlers.local : handlers.remote;
+    }
+    // Removes the event handler with the id returned when it was registered, it is safe to remove a handler while the event runs
+    // Returns false if the handler was already removed
+    bool RemoveEventHandler(uint32_t id)
+    {
+        return eventHandlerSlots.Remove(id);
     }
     void HandleCustomEvent(const alt::CEvent* event, bool local = true);
+    // Calls the handlers of the custom event, the player is the sender of remote events
+    void CallCustomEventHandlers(uint32_t eventId, bool local, alt::IPlayer* player, const alt::MValueArgs& args);
 
-    // Creates a new timer
+    // Creates a new timer, the timer takes over the reference to the callback
     uint32_t CreateTimer(uint32_t timeout, asIScriptFunction* callback, bool once)
     {
-        uint32_t id = nextTimerId++;
-        timers[id] = new Helpers::Timer{this, callback, timeout, GetTime(), once};
+        return AddTimer(Helpers::Timer{callback, timeout, GetTime(), once});
+    }
+    // Adds the timer, the timer takes over the references of its callback, argument and token
+    uint32_t AddTimer(Helpers::Timer timer)
+    {
+        uint32_t id = timers.Add(timer);
+        if(id == 0)
+        {
+            timer.Release();
+            return 0;
+        }
+        timerQueue.push({timer.GetNextRun(), id});
 
         return id;
     }
+    // Adds a callback for every tick or only the next tick, returns an id that can be removed like a timer
+    uint32_t AddTickCallback(asIScriptFunction* callback, bool once)
+    {
+        uint32_t id = once ? nextTickCallbacks.Add(callback) : everyTickCallbacks.Add(callback);
+        if(id == 0) callback->Release();
+        return id;
+    }
+    // Releases the callback right away, it is safe to remove a timer from its own callback
     void RemoveTimer(uint32_t id)
     {
-        invalidTimers.emplace_back(id);
+        if(!Helpers::TickQueue::IsTickId(id)) timers.Remove(id);
+        else if(Helpers::TickQueue::IsOnceId(id)) nextTickCallbacks.Remove(id);
+        else everyTickCallbacks.Remove(id);
+    }
+    bool SetTimerPriority(uint32_t id, Helpers::Timer::Priority priority)
+    {
+        auto timer = timers.Get(id);
+        if(timer == nullptr) return false;
+        timer->SetPriority(priority);
+        return true;
+    }
+    const TimerStats& GetTimerStats()
+    {
+        return timerStats;
     }
 
-    // Yoinked from v8 helpers
     int64_t GetTime()
-	{
-		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-	}
+    {
+        return Helpers::GetTime();
+    }
 
     bool Start();
     bool Stop();
 
+    // Rebuilds the module and moves the script state (globals, event handlers, timers) over to it
+    // If the build fails the current module is kept
+    bool HotReload();
+    // Watches the script files of the resource for changes (only in debug mode)
+    void WatchFiles();
+    // Replaces the current module with the new one and restores the script state in it
+    bool SwapModule(asIScriptModule* newModule);
+    // Schedules a hot reload for the next tick, the module can't be replaced while a script is executing
+    void RequestHotReload()
+    {
+        hotReloadPending = true;
+    }
+
     bool OnEvent(const alt::CEvent* event);
+    // Sets the args of an event on the prepared context, args points to the args built by the event
+    using EventArgsSetter = void(*)(asIScriptContext* context, const void* args);
+    // Calls the handlers with the same args, the return values of bool events are combined by the policy
+    // Returns the result of the event
+    bool CallEventHandlers(Helpers::EventHandlerList& handlers, Helpers::EventReturnKind returnKind, Helpers::EventCombinePolicy policy, EventArgsSetter setArgs, const void* args);
     void OnTick();
+    // Runs the due timers, normal priority timers are deferred to the next ticks if the tick budget is used up
+    void UpdateTimers(int64_t time);
 
     void OnCreateBaseObject(alt::IBaseObject* object) {}
     void OnRemoveBaseObject(alt::IBaseObject* object) {}
@@ -2,6 +2,7 @@
 #include "resource.h"
 #include "helpers/module.h"
 #include "helpers/events.h"
+#include "helpers/hash.h"
 #include "bindings/vector3.h"
 #include "bindings/vector2.h"
 #include "angelscript/addon/scriptstdstring/scriptstdstring.h"
@@ -12,55 +13,99 @@
 #include "angelscript/addon/scriptany/scriptany.h"
 #include "angelscript/addon/datetime/datetime.h"
 
+// Contexts requested by the engine or add-ons (e.g. for calling script callbacks) are taken from the pool of the calling resource
+static asIScriptContext* RequestContext(asIScriptEngine* engine, void* param)
+{
+    auto active = asGetActiveContext();
+    auto resource = active != nullptr ? static_cast<AngelScriptResource*>(active->GetUserData()) : nullptr;
+    if(resource == nullptr) return engine->CreateContext();
+    return resource->GetContextPool().Request();
+}
+
+static void ReturnContext(asIScriptEngine* engine, asIScriptContext* context, void* param)
+{
+    auto resource = static_cast<AngelScriptResource*>(context->GetUserData());
+    if(resource == nullptr) context->Release();
+    else resource->GetContextPool().Return(context);
+}
+
 AngelScriptRuntime::AngelScriptRuntime()
 {
     using namespace Helpers;
+    PhaseTimings timings("the AngelScript runtime");
 
     // Create a new AngelScript engine
-    engine = asCreateScriptEngine();
-    engine->SetMessageCallback(asFUNCTION(Helpers::MessageHandler), 0, asCALL_CDECL);
+    {
+        PhaseTimings::Scope scope(timings, "Engine creation");
+        engine = asCreateScriptEngine();
+        engine->SetMessageCallback(asFUNCTION(Helpers::MessageHandler), 0, asCALL_CDECL);
+        engine->SetContextCallbacks(RequestContext, ReturnContext, this);
+    }
 
     // Optimization
     engine->SetEngineProperty(asEP_BUILD_WITHOUT_LINE_CUES, true);
+    if(jitCompiler.IsAvailable())
+    {
+        // Changes the bytecode, so it has to be set before the interface hash is calculated
+        engine->SetEngineProperty(asEP_INCLUDE_JIT_INSTRUCTIONS, true);
+        engine->SetJITCompiler(&jitCompiler);
+    }
 
-    // Create docs
-    Helpers::DocsGenerator altGen("alt");
-    
-    RegisterScriptInterfaces(engine, &altGen);
+    // The docs are generated by the separate 'angelscript-docs' target, so no docs generator is passed here
+    RegisterScriptInterfaces(engine, nullptr, &timings);
 
-    // Generate docs
-    altGen.Generate();
+    // Cache type infos
+    {
+        PhaseTimings::Scope scope(timings, "Type infos");
+        RegisterTypeInfos();
+    }
+    {
+        PhaseTimings::Scope scope(timings, "Interface hash");
+        CalculateInterfaceHash();
+    }
+
+    timings.Print();
+    timings.WriteJson(alt::ICore::Instance().GetRootDirectory().ToString() + "/cache/angelscript/startup/runtime.json");
 }
 
-void AngelScriptRuntime::RegisterScriptInterfaces(asIScriptEngine* engine, DocsGenerator* docs)
+void AngelScriptRuntime::RegisterScriptInterfaces(asIScriptEngine* engine, DocsGenerator* docs, PhaseTimings* timings)
 {
+    PhaseTimings unused("");
+    if(timings == nullptr) timings = &unused;
+
     // Register add-ons
-    RegisterStdString(engine);
-    RegisterScriptArray(engine, true);
-    RegisterStdStringUtils(engine);
-    RegisterScriptDictionary(engine);
-    RegisterScriptMath(engine);
-    RegisterScriptAny(engine);
-    RegisterScriptDateTime(engine);
-    RegisterExceptionRoutines(engine);
+    {
+        PhaseTimings::Scope scope(*timings, "Add-ons");
+        RegisterStdString(engine);
+        RegisterScriptArray(engine, true);
+        RegisterStdStringUtils(engine);
+        RegisterScriptDictionary(engine);
+        RegisterScriptMath(engine);
+        RegisterScriptAny(engine);
+        RegisterScriptDateTime(engine);
+        RegisterExceptionRoutines(engine);
+    }
 
     // Register classes
-    Helpers::RegisterVector3(engine, docs);
-    Helpers::RegisterVector2(engine, docs);
-    REGISTER_REF_CLASS("BaseObject", alt::IBaseObject, asOBJ_REF, "Base object superclass for all alt:V base objects");
-    REGISTER_REF_CLASS("WorldObject", alt::IWorldObject, asOBJ_REF, "World object superclass for all alt:V world objects");
-    REGISTER_REF_CLASS("Entity", alt::IEntity, asOBJ_REF, "Entity superclass for all alt:V entities");
-    REGISTER_REF_CLASS("Player", alt::IPlayer, asOBJ_REF, "alt:V Player Entity");
-    REGISTER_REF_CLASS("Vehicle", alt::IVehicle, asOBJ_REF, "alt:V Vehicle Entity");
+    {
+        PhaseTimings::Scope scope(*timings, "Classes");
+        Helpers::RegisterVector3(engine, docs);
+        Helpers::RegisterVector2(engine, docs);
+        REGISTER_REF_CLASS("BaseObject", alt::IBaseObject, asOBJ_REF, "Base object superclass for all alt:V base objects");
+        REGISTER_REF_CLASS("WorldObject", alt::IWorldObject, asOBJ_REF, "World object superclass for all alt:V world objects");
+        REGISTER_REF_CLASS("Entity", alt::IEntity, asOBJ_REF, "Entity superclass for all alt:V entities");
+        REGISTER_REF_CLASS("Player", alt::IPlayer, asOBJ_REF, "alt:V Player Entity");
+        REGISTER_REF_CLASS("Vehicle", alt::IVehicle, asOBJ_REF, "alt:V Vehicle Entity");
+    }
 
     // Register extensions
-    ModuleExtension::RegisterAll("alt", engine, docs);
+    ModuleExtension::RegisterAll("alt", engine, docs, timings);
 
     // Register events
-    Event::RegisterAll(engine, docs);
-
-    // Cache type infos
-    RegisterTypeInfos();
+    {
+        PhaseTimings::Scope scope(*timings, "Events");
+        Event::RegisterAll(engine, docs);
+    }
 }
 
 void AngelScriptRuntime::RegisterTypeInfos()
@@ -76,6 +121,68 @@ void AngelScriptRuntime::RegisterTypeInfos()
     arrayAnyTypeInfo->AddRef();
 }
 
+void AngelScriptRuntime::CalculateInterfaceHash()
+{
+    // Everything that influences the compiled bytecode has to be part of the hash
+    uint64_t hash = Hash64(ANGELSCRIPT_VERSION_STRING);
+    for(int i = 1; i < asEP_LAST_PROPERTY; i++)
+    {
+        asPWORD value = engine->GetEngineProperty((asEEngineProp)i);
+        hash = Hash64(&value, sizeof(value), hash);
+    }
+
+    for(asUINT i = 0; i < engine->GetGlobalFunctionCount(); i++)
+    {
+        hash = Hash64(engine->GetGlobalFunctionByIndex(i)->GetDeclaration(true, true, true), hash);
+    }
+    for(asUINT i = 0; i < engine->GetGlobalPropertyCount(); i++)
+    {
+        const char* name;
+        const char* nameSpace;
+        int typeId;
+        engine->GetGlobalPropertyByIndex(i, &name, &nameSpace, &typeId);
+        hash = Hash64(name, hash);
+        hash = Hash64(nameSpace, hash);
+        hash = Hash64(engine->GetTypeDeclaration(typeId, true), hash);
+    }
+    for(asUINT i = 0; i < engine->GetObjectTypeCount(); i++)
+    {
+        auto type = engine->GetObjectTypeByIndex(i);
+        hash = Hash64(type->GetName(), hash);
+        hash = Hash64(type->GetNamespace(), hash);
+        asDWORD flags = type->GetFlags();
+        hash = Hash64(&flags, sizeof(flags), hash);
+        for(asUINT n = 0; n < type->GetBehaviourCount(); n++)
+        {
+            hash = Hash64(type->GetBehaviourByIndex(n, nullptr)->GetDeclaration(true, true, true), hash);
+        }
+        for(asUINT n = 0; n < type->GetMethodCount(); n++)
+        {
+            hash = Hash64(type->GetMethodByIndex(n)->GetDeclaration(true, true, true), hash);
+        }
+        for(asUINT n = 0; n < type->GetPropertyCount(); n++)
+        {
+            hash = Hash64(type->GetPropertyDeclaration(n, true), hash);
+        }
+    }
+    for(asUINT i = 0; i < engine->GetEnumCount(); i++)
+    {
+        auto type = engine->GetEnumByIndex(i);
+        hash = Hash64(type->GetName(), hash);
+        for(asUINT n = 0; n < type->GetEnumValueCount(); n++)
+        {
+            int value;
+            hash = Hash64(type->GetEnumValueByIndex(n, &value), hash);
+            hash = Hash64(&value, sizeof(value), hash);
+        }
+    }
+    for(asUINT i = 0; i < engine->GetFuncdefCount(); i++)
+    {
+        hash = Hash64(engine->GetFuncdefByIndex(i)->GetFuncdefSignature()->GetDeclaration(true, true, true), hash);
+    }
+    interfaceHash = hash;
+}
+
 // Creates an array of strings
 CScriptArray* AngelScriptRuntime::CreateStringArray(uint32_t len)
 {
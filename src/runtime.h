@@ -4,6 +4,10 @@
 #include "Log.h"
 #include "angelscript/include/angelscript.h"
 #include "helpers/docs.h"
+#include "helpers/watcher.h"
+#include "helpers/timings.h"
+#include "helpers/jit.h"
+#include "helpers/watchdog.h"
 
 class AngelScriptResource;
 class AngelScriptRuntime : public alt::IScriptRuntime
@@ -16,6 +20,18 @@ class AngelScriptRuntime : public alt::IScriptRuntime
     asITypeInfo* arrayUintTypeInfo = nullptr;
     asITypeInfo* arrayAnyTypeInfo = nullptr;
 
+    // Watches the script files of the resources in debug mode
+    Helpers::FileWatcher fileWatcher;
+
+    // Compiles the functions of resources that enabled the JIT to native code
+    Helpers::JITCompiler jitCompiler;
+
+    // Interrupts script calls exceeding the budget of their resource
+    Helpers::Watchdog watchdog;
+
+    // Hash of the registered script interface, used to invalidate cached bytecode
+    uint64_t interfaceHash = 0;
+
 public:
     AngelScriptRuntime();
     alt::IResource::Impl* CreateImpl(alt::IResource* resource) override;
@@ -25,14 +41,32 @@ public:
     {
         return engine;
     }
+    Helpers::FileWatcher& GetFileWatcher()
+    {
+        return fileWatcher;
+    }
+    Helpers::JITCompiler& GetJITCompiler()
+    {
+        return jitCompiler;
+    }
+    Helpers::Watchdog& GetWatchdog()
+    {
+        return watchdog;
+    }
+    uint64_t GetInterfaceHash()
+    {
+        return interfaceHash;
+    }
 
     CScriptArray* CreateStringArray(uint32_t len);
     CScriptArray* CreateIntArray(uint32_t len);
     CScriptArray* CreateUIntArray(uint32_t);
     CScriptArray* CreateAnyArray(uint32_t);
     void RegisterTypeInfos();
+    void CalculateInterfaceHash();
     // Register the script interfaces (the scripting api)
-    void RegisterScriptInterfaces(asIScriptEngine* engine, Helpers::DocsGenerator* docs);
+    // Static so the docs generator can register them against its own engine
+    static void RegisterScriptInterfaces(asIScriptEngine* engine, Helpers::DocsGenerator* docs, Helpers::PhaseTimings* timings = nullptr);
 
     int GetStringTypeId()
     {
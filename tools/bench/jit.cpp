@@ -0,0 +1,125 @@
+// Measures the speedup of the JIT on representative scripts
+// Runs the same scripts in the interpreter, with only the hot functions compiled ('#pragma jit') and with all
+// functions compiled ('#pragma jit all') and prints the times
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "helpers/jit.h"
+#include "angelscript/addon/scriptarray/scriptarray.h"
+#include "angelscript/addon/scriptmath/scriptmath.h"
+
+// Damage math like in a weapon damage handler and a per tick loop over the players
+static const char* script = R"(
+float CalculateDamage(float base, float distance, int bone, bool armour)
+{
+    float damage = base * (1.0f - min(distance / 150.0f, 0.75f));
+    if(bone == 31086) damage *= 2.5f;
+    else if(bone >= 50000) damage *= 0.6f;
+    if(armour) damage *= 0.7f;
+    return damage;
+}
+
+float BenchDamage(int iterations)
+{
+    float total = 0;
+    for(int i = 0; i < iterations; i++)
+    {
+        total += CalculateDamage(35.0f, float(i % 200), (i % 7) * 10000, i % 3 == 0);
+    }
+    return total;
+}
+
+float BenchTick(int iterations)
+{
+    array<float> health(256, 200.0f);
+    array<float> x(256), y(256);
+    float closest = 0;
+    for(int tick = 0; tick < iterations / 256; tick++)
+    {
+        closest = 1e9f;
+        for(uint i = 0; i < health.length(); i++)
+        {
+            x[i] += 0.5f;
+            y[i] -= 0.25f;
+            if(health[i] < 200.0f) health[i] += 0.1f;
+            float distance = sqrt(x[i] * x[i] + y[i] * y[i]);
+            if(distance < closest) closest = distance;
+        }
+    }
+    return closest;
+}
+)";
+
+static void MessageHandler(const asSMessageInfo* msg, void* param)
+{
+    const char* type = msg->type == asMSGTYPE_ERROR ? "ERROR" : msg->type == asMSGTYPE_WARNING ? "WARNING" : "INFO";
+    std::cout << "[" << type << "] " << msg->section << " (" << msg->row << ", " << msg->col << "): " << msg->message << std::endl;
+}
+
+// Returns the time in ms each benchmark function took, or an empty vector if the script failed
+static std::vector<double> Run(bool useJit, bool all, const std::vector<std::string>& functions, int iterations)
+{
+    Helpers::JITCompiler jit;
+    asIScriptEngine* engine = asCreateScriptEngine();
+    engine->SetMessageCallback(asFUNCTION(MessageHandler), 0, asCALL_CDECL);
+    RegisterScriptArray(engine, true);
+    RegisterScriptMath(engine);
+    if(useJit)
+    {
+        engine->SetEngineProperty(asEP_INCLUDE_JIT_INSTRUCTIONS, true);
+        engine->SetJITCompiler(&jit);
+        jit.SetEnabled("bench", true, all);
+    }
+
+    std::vector<double> times;
+    asIScriptModule* mod = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+    mod->AddScriptSection("bench", script);
+    if(mod->Build() < 0)
+    {
+        engine->ShutDownAndRelease();
+        return times;
+    }
+    jit.Finalize();
+
+    asIScriptContext* context = engine->CreateContext();
+    for(auto& name : functions)
+    {
+        asIScriptFunction* func = mod->GetFunctionByName(name.c_str());
+        context->Prepare(func);
+        context->SetArgDWord(0, iterations);
+        auto start = std::chrono::steady_clock::now();
+        int r = context->Execute();
+        auto end = std::chrono::steady_clock::now();
+        if(r != asEXECUTION_FINISHED)
+        {
+            std::cout << name << " did not finish (" << r << ")" << std::endl;
+            times.clear();
+            break;
+        }
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    context->Release();
+    engine->ShutDownAndRelease();
+    return times;
+}
+
+int main(int argc, char** argv)
+{
+    // Usage: angelscript-jit-bench [iterations]
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 10000000;
+    std::vector<std::string> functions = { "BenchDamage", "BenchTick" };
+
+    auto interpreted = Run(false, false, functions, iterations);
+    auto hot = Run(true, false, functions, iterations);
+    auto all = Run(true, true, functions, iterations);
+    if(interpreted.empty() || hot.empty() || all.empty()) return 1;
+
+    std::cout << "Iterations: " << iterations << std::endl;
+    for(size_t i = 0; i < functions.size(); i++)
+    {
+        std::cout << functions[i] << ": interpreter " << interpreted[i] << "ms, jit " << hot[i] << "ms ("
+                  << interpreted[i] / hot[i] << "x), jit all " << all[i] << "ms (" << interpreted[i] / all[i] << "x)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Measures the cost of a tick with many timers, using the same timer slab and min-heap as the resources
+// The timers have no callback, so only the bookkeeping is measured
+// For comparison the tick is also done by scanning all timers, like the resources did before the heap
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <vector>
+#include "helpers/timer.h"
+
+struct ScheduledTimer
+{
+    int64_t nextRun;
+    uint32_t id;
+
+    bool operator>(const ScheduledTimer& other) const
+    {
+        if(nextRun != other.nextRun) return nextRun > other.nextRun;
+        return id > other.id;
+    }
+};
+using TimerQueue = std::priority_queue<ScheduledTimer, std::vector<ScheduledTimer>, std::greater<ScheduledTimer>>;
+
+struct Result
+{
+    double tickTime = 0;
+    uint64_t executed = 0;
+};
+
+static void AddTimers(Helpers::TimerSlab& timers, TimerQueue* queue, uint32_t count)
+{
+    // Intervals between 50ms and 10s, a mix of fast update loops and slow periodic jobs
+    std::mt19937 random(count);
+    std::uniform_int_distribution<uint32_t> intervals(50, 10000);
+    for(uint32_t i = 0; i < count; i++)
+    {
+        Helpers::Timer timer{nullptr, intervals(random), 0, false};
+        uint32_t id = timers.Add(timer);
+        if(queue != nullptr) queue->push({timer.GetNextRun(), id});
+    }
+}
+
+// Same as AngelScriptResource::UpdateTimers, only the due timers are touched
+static Result RunHeap(uint32_t count, uint32_t ticks, int64_t tickTime)
+{
+    Helpers::TimerSlab timers;
+    TimerQueue queue;
+    AddTimers(timers, &queue, count);
+
+    Result result;
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t tick = 1; tick <= ticks; tick++)
+    {
+        int64_t time = tick * tickTime;
+        while(!queue.empty() && queue.top().nextRun <= time)
+        {
+            uint32_t id = queue.top().id;
+            queue.pop();
+            auto timer = timers.Get(id);
+            if(timer == nullptr) continue;
+            result.executed++;
+            if(timer->Reschedule(time)) queue.push({timer->GetNextRun(), id});
+            else timers.Remove(id);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.tickTime = std::chrono::duration<double, std::micro>(end - start).count() / ticks;
+    return result;
+}
+
+// Every timer is checked on every tick
+static Result RunScan(uint32_t count, uint32_t ticks, int64_t tickTime)
+{
+    Helpers::TimerSlab timers;
+    AddTimers(timers, nullptr, count);
+
+    Result result;
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t tick = 1; tick <= ticks; tick++)
+    {
+        int64_t time = tick * tickTime;
+        timers.ForEach([&](uint32_t id, Helpers::Timer& timer) {
+            if(!timer.IsDue(time)) return;
+            result.executed++;
+            if(!timer.Reschedule(time)) timers.Remove(id);
+        });
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.tickTime = std::chrono::duration<double, std::micro>(end - start).count() / ticks;
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    // Usage: angelscript-timer-bench [ticks]
+    // Simulates a server running at ~60 ticks per second
+    uint32_t ticks = argc > 1 ? (uint32_t)std::stoul(argv[1]) : 6000;
+    const int64_t tickTime = 16;
+
+    std::cout << "Ticks: " << ticks << " (" << ticks * tickTime / 1000 << "s)" << std::endl;
+    for(uint32_t count : { 10000, 25000, 50000, 100000 })
+    {
+        Result heap = RunHeap(count, ticks, tickTime);
+        Result scan = RunScan(count, ticks, tickTime);
+        std::cout << count << " timers: heap " << heap.tickTime << "us per tick, scan " << scan.tickTime << "us per tick, "
+                  << heap.executed / ticks << " due timers per tick" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Creates and expires millions of timeouts and prints the memory usage, which should stay flat
+// The timeouts hold a reference to a script function, so leaked callback references are detected as well
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "helpers/timer.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <fstream>
+#endif
+
+struct ScheduledTimer
+{
+    int64_t nextRun;
+    uint32_t id;
+
+    bool operator>(const ScheduledTimer& other) const
+    {
+        if(nextRun != other.nextRun) return nextRun > other.nextRun;
+        return id > other.id;
+    }
+};
+
+// Resident memory of the process in KB
+static size_t GetResidentMemory()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize / 1024;
+#else
+    size_t size = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> size >> resident;
+    return resident * sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+// Returns the reference count of the function without changing it
+static int GetRefCount(asIScriptFunction* func)
+{
+    int count = func->AddRef() - 1;
+    func->Release();
+    return count;
+}
+
+int main(int argc, char** argv)
+{
+    // Usage: angelscript-timer-memory-bench [timeouts in millions]
+    uint64_t total = (argc > 1 ? std::stoull(argv[1]) : 10) * 1000000;
+    // Simulates a server running at ~60 ticks per second, with a few thousand new timeouts per tick
+    const int64_t tickTime = 16;
+    const uint32_t perTick = 2000;
+
+    asIScriptEngine* engine = asCreateScriptEngine();
+    asIScriptModule* mod = engine->GetModule("bench", asGM_ALWAYS_CREATE);
+    mod->AddScriptSection("bench", "void OnTimeout() {}");
+    if(mod->Build() < 0)
+    {
+        engine->ShutDownAndRelease();
+        return 1;
+    }
+    asIScriptFunction* callback = mod->GetFunctionByName("OnTimeout");
+    int refCount = GetRefCount(callback);
+
+    std::mt19937 random(0);
+    std::uniform_int_distribution<uint32_t> timeouts(0, 5000);
+    uint64_t created = 0, expired = 0;
+    {
+        Helpers::TimerSlab timers;
+        std::priority_queue<ScheduledTimer, std::vector<ScheduledTimer>, std::greater<ScheduledTimer>> queue;
+        std::cout << "Start: " << GetResidentMemory() << "KB" << std::endl;
+
+        for(int64_t time = tickTime; created < total; time += tickTime)
+        {
+            for(uint32_t i = 0; i < perTick && created < total; i++, created++)
+            {
+                callback->AddRef();
+                Helpers::Timer timer{callback, timeouts(random), time, true};
+                uint32_t id = timers.Add(timer);
+                if(id == 0)
+                {
+                    timer.Release();
+                    std::cout << "Failed to add a timeout" << std::endl;
+                    return 1;
+                }
+                queue.push({timer.GetNextRun(), id});
+
+                if((created + 1) % 1000000 == 0)
+                {
+                    std::cout << (created + 1) / 1000000 << "M timeouts: " << timers.GetCount() << " pending, "
+                              << GetResidentMemory() << "KB" << std::endl;
+                }
+            }
+
+            // Same as AngelScriptResource::UpdateTimers for timeouts, the callback is released when the timer is removed
+            while(!queue.empty() && queue.top().nextRun <= time)
+            {
+                if(timers.Remove(queue.top().id)) expired++;
+                queue.pop();
+            }
+        }
+        std::cout << "Expired " << expired << " of " << created << " timeouts, the rest is released with the slab" << std::endl;
+    }
+
+    int leaked = GetRefCount(callback) - refCount;
+    std::cout << "Leaked callback references: " << leaked << std::endl;
+    engine->ShutDownAndRelease();
+    return leaked == 0 ? 0 : 1;
+}
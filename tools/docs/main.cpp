@@ -0,0 +1,29 @@
+// Generates the script api documentation ('altDocs.as')
+// Registers the same script interfaces as the module, but against a headless engine,
+// so the module itself doesn't have to do any docs work on startup
+#include <iostream>
+#include "runtime.h"
+#include "helpers/docs.h"
+
+static void MessageHandler(const asSMessageInfo* msg, void* param)
+{
+    const char* type = msg->type == asMSGTYPE_ERROR ? "ERROR" : msg->type == asMSGTYPE_WARNING ? "WARNING" : "INFO";
+    std::cout << "[" << type << "] " << msg->section << " (" << msg->row << ", " << msg->col << "): " << msg->message << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    // Usage: angelscript-docs [output directory]
+    std::string outputDir = argc > 1 ? std::string(argv[1]) + "/" : "";
+
+    asIScriptEngine* engine = asCreateScriptEngine();
+    engine->SetMessageCallback(asFUNCTION(MessageHandler), 0, asCALL_CDECL);
+
+    Helpers::DocsGenerator docs("alt");
+    AngelScriptRuntime::RegisterScriptInterfaces(engine, &docs);
+    docs.Generate(outputDir);
+
+    engine->ShutDownAndRelease();
+    std::cout << "Generated " << outputDir << "altDocs.as" << std::endl;
+    return 0;
+}